@@ -0,0 +1,1048 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/*
+ * Benchmarks of the modules of the alarm server. They run without the
+ * server, so that the queue backends, the registry profiles and the
+ * notification path can be compared on the target. Only the bus benchmark
+ * needs a bus, the session bus by default:
+ *
+ *	alarm-bench table [alarms...]
+ *	alarm-bench queue [alarms] [expiries]
+ *	alarm-bench scan [alarms] [rounds]
+ *	alarm-bench registry [alarms] [db file]
+ *	alarm-bench load [alarms] [db file]
+ *	alarm-bench bus [bus address]
+ *	alarm-bench schedule [cases]
+ *
+ * Every benchmark uses the same seed, so that the backends are given the
+ * same workload. The schedule check is not timed : it compares the due
+ * times of the scheduler with the ones of the loops it replaced, and fails
+ * on a difference.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <dbus/dbus.h>
+#include <glib.h>
+#include <db-util.h>
+
+#include "alarm.h"
+#include "alarm-internal.h"
+
+#define BENCH_SEED 1
+#define BENCH_PERIOD_MAX (60 * 60 * 24 * 30)
+#define BENCH_APPS 16
+/* lookups by walking a list are slow, so fewer of them are timed */
+#define BENCH_LIST_LOOKUPS 1000
+/* on the same storage as the registry, so that fsync costs the same */
+#define BENCH_DB_FILE "/opt/dbspace/.alarm-bench.db"
+
+static const char *bench_profiles[] = { "rollback", "wal", "wal-full" };
+
+/* numbers of alarms expired at once */
+static const int bench_batches[] = { 1, 100, 1000 };
+
+/* the modules refer to these definitions of alarm-manager.c */
+__alarm_server_context_t alarm_context;
+bool g_dummy_timer_is_set = FALSE;
+GSList *g_scheduled_alarm_list = NULL;
+bool enable_power_on_alarm;
+sqlite3 *alarmmgr_db;
+
+int _set_rtc_time(time_t _time)
+{
+	return 0;
+}
+
+/* the current time of the modules. The schedule check sets it, it is the
+   real time while it is 0 */
+static time_t bench_clock;
+
+time_t time(time_t *t)
+{
+	struct timespec ts;
+	time_t now = bench_clock;
+
+	if (now == 0) {
+		clock_gettime(CLOCK_REALTIME, &ts);
+		now = ts.tv_sec;
+	}
+	if (t != NULL)
+		*t = now;
+	return now;
+}
+
+static double __bench_now()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void __bench_report(const char *name, const char *phase, int count,
+			   double start)
+{
+	double elapsed = __bench_now() - start;
+
+	printf("%-8s %-10s %9d ops %10.1f ns/op\n", name, phase, count,
+	       count > 0 ? elapsed * 1e9 / count : 0.0);
+}
+
+static int __bench_arg(int argc, char **argv, int idx, int def)
+{
+	if (argc > idx && atoi(argv[idx]) > 0)
+		return atoi(argv[idx]);
+	return def;
+}
+
+/* periods from seconds to a month, most alarms are near */
+static time_t __bench_period()
+{
+	switch (rand() % 4) {
+	case 0:
+		return 1 + rand() % 60;
+	case 1:
+		return 1 + rand() % (60 * 60);
+	case 2:
+		return 1 + rand() % (60 * 60 * 24);
+	default:
+		return 1 + rand() % BENCH_PERIOD_MAX;
+	}
+}
+
+static void __bench_shuffle(alarm_id_t *ids, int count)
+{
+	alarm_id_t tmp;
+	int i;
+	int j;
+
+	for (i = count - 1; i > 0; i--) {
+		j = rand() % (i + 1);
+		tmp = ids[i];
+		ids[i] = ids[j];
+		ids[j] = tmp;
+	}
+}
+
+static __alarm_info_t *__bench_list_find(GSList *alarms, alarm_id_t alarm_id)
+{
+	GSList *iter = NULL;
+	__alarm_info_t *entry = NULL;
+
+	for (iter = alarms; iter != NULL; iter = g_slist_next(iter)) {
+		entry = iter->data;
+		if (entry->alarm_id == alarm_id)
+			return entry;
+	}
+
+	return NULL;
+}
+
+/*
+ * Adds the alarms in the order of their ids, as the id allocator gives them
+ * out, then finds and removes them in random order. The lookups are also
+ * timed on a list of the same alarms, which is how the alarms were kept
+ * before the table.
+ */
+static void __bench_table_size(int nr_alarms)
+{
+	alarm_id_t *ids = g_new0(alarm_id_t, nr_alarms);
+	GQuark apps[BENCH_APPS];
+	GSList *list = NULL;
+	__alarm_info_t *entry = NULL;
+	char name[32];
+	char label[16];
+	time_t now = time(NULL);
+	double start;
+	int lookups;
+	int i;
+
+	srand(BENCH_SEED);
+	_alarm_queue_init("heap");
+	_alarm_table_init();
+	snprintf(label, sizeof(label), "%d", nr_alarms);
+
+	for (i = 0; i < BENCH_APPS; i++) {
+		snprintf(name, sizeof(name), "org.tizen.bench%d", i);
+		apps[i] = g_quark_from_string(name);
+	}
+	for (i = 0; i < nr_alarms; i++) {
+		ids[i] = i + 1;
+	}
+
+	start = __bench_now();
+	for (i = 0; i < nr_alarms; i++) {
+		entry = _alarm_info_new();
+		entry->alarm_id = ids[i];
+		entry->quark_app_unique_name = apps[i % BENCH_APPS];
+		entry->due_time = now + __bench_period();
+		_alarm_table_add(entry);
+		list = g_slist_prepend(list, entry);
+	}
+	__bench_report(label, "add", nr_alarms, start);
+
+	__bench_shuffle(ids, nr_alarms);
+	start = __bench_now();
+	for (i = 0; i < nr_alarms; i++) {
+		_alarm_table_find(ids[i]);
+	}
+	__bench_report(label, "find", nr_alarms, start);
+
+	lookups = MIN(nr_alarms, BENCH_LIST_LOOKUPS);
+	start = __bench_now();
+	for (i = 0; i < lookups; i++) {
+		__bench_list_find(list, ids[i]);
+	}
+	__bench_report(label, "list find", lookups, start);
+
+	g_slist_free(list);
+	start = __bench_now();
+	for (i = 0; i < nr_alarms; i++) {
+		_alarm_table_remove(ids[i]);
+	}
+	__bench_report(label, "remove", nr_alarms, start);
+
+	_alarm_queue_clear();
+	g_free(ids);
+}
+
+static int __bench_table(int argc, char **argv)
+{
+	int i;
+
+	if (argc < 3) {
+		__bench_table_size(1000);
+		__bench_table_size(10000);
+		__bench_table_size(100000);
+		return 0;
+	}
+
+	for (i = 2; i < argc; i++) {
+		__bench_table_size(__bench_arg(argc, argv, i, 1000));
+	}
+
+	return 0;
+}
+
+static void __bench_collect(__alarm_info_t *__alarm_info, void *data)
+{
+	g_ptr_array_add((GPtrArray *)data, __alarm_info);
+}
+
+/*
+ * Queues the alarms, then expires them in order as the server does : the
+ * first alarm gives the time, the due alarms are collected and each one is
+ * rescheduled after a random period.
+ */
+static void __bench_queue_backend(const char *backend, int nr_alarms,
+				  int nr_expiries)
+{
+	__alarm_info_t **alarms = g_new0(__alarm_info_t *, nr_alarms);
+	GPtrArray *due = g_ptr_array_new();
+	__alarm_info_t *first = NULL;
+	time_t now;
+	double start;
+	int expired = 0;
+	int i;
+
+	srand(BENCH_SEED);
+	_alarm_queue_init(backend);
+	now = time(NULL);
+
+	for (i = 0; i < nr_alarms; i++) {
+		alarms[i] = _alarm_info_new();
+		alarms[i]->alarm_id = i + 1;
+		alarms[i]->due_time = now + __bench_period();
+	}
+
+	start = __bench_now();
+	for (i = 0; i < nr_alarms; i++) {
+		_alarm_queue_update(alarms[i]);
+	}
+	__bench_report(backend, "insert", nr_alarms, start);
+
+	start = __bench_now();
+	while (expired < nr_expiries) {
+		first = _alarm_queue_first(now);
+		if (first == NULL)
+			break;
+		now = first->due_time;
+
+		g_ptr_array_set_size(due, 0);
+		_alarm_queue_foreach_due(now, __bench_collect, due);
+		for (i = 0; i < due->len; i++) {
+			first = g_ptr_array_index(due, i);
+			first->due_time = now + __bench_period();
+			_alarm_queue_update(first);
+		}
+		expired += due->len;
+	}
+	__bench_report(backend, "expire", expired, start);
+
+	start = __bench_now();
+	for (i = 0; i < nr_alarms; i++) {
+		_alarm_queue_remove(alarms[i]);
+	}
+	__bench_report(backend, "remove", nr_alarms, start);
+
+	for (i = 0; i < nr_alarms; i++) {
+		_alarm_info_free(alarms[i]);
+	}
+	_alarm_queue_clear();
+	g_ptr_array_free(due, TRUE);
+	g_free(alarms);
+}
+
+static void __bench_count(__alarm_info_t *__alarm_info, void *data)
+{
+	(*(int *)data)++;
+}
+
+/*
+ * Measures what the layout of the heap costs : scanning every queued alarm
+ * for the due ones, and moving alarms in the heap when they are
+ * rescheduled. The records are allocated in id order and queued in due_time
+ * order, so the heap does not visit them in memory order, as in the server.
+ */
+static int __bench_scan(int argc, char **argv)
+{
+	int nr_alarms = __bench_arg(argc, argv, 2, 100000);
+	int rounds = __bench_arg(argc, argv, 3, 100);
+	__alarm_info_t **alarms = g_new0(__alarm_info_t *, nr_alarms);
+	time_t now = time(NULL);
+	double start;
+	int visited = 0;
+	int i;
+
+	srand(BENCH_SEED);
+	_alarm_queue_init("heap");
+
+	for (i = 0; i < nr_alarms; i++) {
+		alarms[i] = _alarm_info_new();
+		alarms[i]->alarm_id = i + 1;
+		alarms[i]->due_time = now + __bench_period();
+		_alarm_queue_update(alarms[i]);
+	}
+
+	start = __bench_now();
+	for (i = 0; i < rounds; i++) {
+		_alarm_queue_foreach_due(now + BENCH_PERIOD_MAX, __bench_count,
+					 &visited);
+	}
+	__bench_report("heap", "scan", visited, start);
+
+	start = __bench_now();
+	for (i = 0; i < rounds * 1000; i++) {
+		__alarm_info_t *entry = alarms[rand() % nr_alarms];
+
+		entry->due_time = now + __bench_period();
+		_alarm_queue_update(entry);
+	}
+	__bench_report("heap", "reschedule", rounds * 1000, start);
+
+	for (i = 0; i < nr_alarms; i++) {
+		_alarm_queue_remove(alarms[i]);
+		_alarm_info_free(alarms[i]);
+	}
+	g_free(alarms);
+
+	return 0;
+}
+
+static int __bench_queue(int argc, char **argv)
+{
+	int nr_alarms = __bench_arg(argc, argv, 2, 1000);
+	int nr_expiries = __bench_arg(argc, argv, 3, 100000);
+
+	__bench_queue_backend("heap", nr_alarms, nr_expiries);
+	__bench_queue_backend("wheel", nr_alarms, nr_expiries);
+
+	return 0;
+}
+
+static void __bench_unlink_db(const char *path)
+{
+	const char *suffixes[] = { "", "-journal", "-wal", "-shm" };
+	char file[256];
+	int i;
+
+	for (i = 0; i < G_N_ELEMENTS(suffixes); i++) {
+		snprintf(file, sizeof(file), "%s%s", path, suffixes[i]);
+		unlink(file);
+	}
+}
+
+static bool __bench_open_db(const char *path)
+{
+	char *error_message = NULL;
+
+	__bench_unlink_db(path);
+
+	if (db_util_open(path, &alarmmgr_db, DB_UTIL_REGISTER_HOOK_METHOD)
+	    != SQLITE_OK) {
+		printf("%s is not opened\n", path);
+		return false;
+	}
+
+	if (SQLITE_OK != sqlite3_exec(alarmmgr_db, QUERY_CREATE_TABLE_ALARMMGR,
+				      NULL, NULL, &error_message)
+	    || SQLITE_OK != sqlite3_exec(alarmmgr_db,
+				QUERY_CREATE_TABLE_ALARMMGR_META, NULL, NULL,
+				&error_message)) {
+		printf("tables are not created : %s\n", error_message);
+		sqlite3_free(error_message);
+		return false;
+	}
+
+	return _registry_init(0);
+}
+
+/*
+ * Creates, updates and deletes the alarms with a storage profile. Every
+ * operation is flushed in its own transaction, as the server writes the
+ * requests which come one by one.
+ */
+static void __bench_registry_profile(const char *profile, int nr_alarms)
+{
+	GQuark app = g_quark_from_string("org.tizen.bench");
+	__alarm_info_t *entry = NULL;
+	time_t now = time(NULL);
+	double start;
+	int i;
+
+	srand(BENCH_SEED);
+	_registry_set_profile(profile);
+
+	start = __bench_now();
+	for (i = 0; i < nr_alarms; i++) {
+		entry = _alarm_info_new();
+		entry->alarm_id = i + 1;
+		entry->quark_app_unique_name = app;
+		entry->due_time = now + __bench_period();
+		_alarm_table_add(entry);
+		_save_alarms(entry);
+		_registry_flush();
+	}
+	__bench_report(profile, "create", nr_alarms, start);
+
+	start = __bench_now();
+	for (i = 0; i < nr_alarms; i++) {
+		entry = _alarm_table_find(i + 1);
+		entry->due_time += __bench_period();
+		_alarm_queue_update(entry);
+		_update_alarms(entry);
+		_registry_flush();
+	}
+	__bench_report(profile, "update", nr_alarms, start);
+
+	start = __bench_now();
+	for (i = 0; i < nr_alarms; i++) {
+		_alarm_table_remove(i + 1);
+		_delete_alarms(i + 1);
+		_registry_flush();
+	}
+	__bench_report(profile, "delete", nr_alarms, start);
+}
+
+static int __bench_registry(int argc, char **argv)
+{
+	int nr_alarms = __bench_arg(argc, argv, 2, 1000);
+	const char *path = argc > 3 ? argv[3] : BENCH_DB_FILE;
+	int i;
+
+	_alarm_queue_init("heap");
+	_alarm_table_init();
+
+	if (!__bench_open_db(path))
+		return -1;
+
+	for (i = 0; i < G_N_ELEMENTS(bench_profiles); i++) {
+		__bench_registry_profile(bench_profiles[i], nr_alarms);
+	}
+
+	db_util_close(alarmmgr_db);
+	__bench_unlink_db(path);
+
+	return 0;
+}
+
+/*
+ * Fills a registry with repeating alarms which started in the past, in one
+ * transaction, then times the startup load of it in the eager and the lazy
+ * boot modes. In the eager mode the due time of every alarm is computed
+ * while it is loaded.
+ */
+static int __bench_load(int argc, char **argv)
+{
+	static const char *modes[] = { "eager", "lazy" };
+	int nr_alarms = __bench_arg(argc, argv, 2, 100000);
+	const char *path = argc > 3 ? argv[3] : BENCH_DB_FILE;
+	GQuark apps[BENCH_APPS];
+	__alarm_info_t *entry = NULL;
+	alarm_date_t *date = NULL;
+	struct tm start_tm;
+	char name[32];
+	time_t now = time(NULL);
+	time_t first;
+	double start;
+	int i;
+
+	srand(BENCH_SEED);
+	_alarm_queue_init("heap");
+	_alarm_table_init();
+
+	if (!__bench_open_db(path))
+		return -1;
+	_registry_set_profile(NULL);
+
+	for (i = 0; i < BENCH_APPS; i++) {
+		snprintf(name, sizeof(name), "org.tizen.bench%d", i);
+		apps[i] = g_quark_from_string(name);
+	}
+
+	for (i = 0; i < nr_alarms; i++) {
+		entry = _alarm_info_new();
+		entry->alarm_id = i + 1;
+		entry->quark_app_unique_name = apps[i % BENCH_APPS];
+		entry->quark_dst_service_name = apps[i % BENCH_APPS];
+		entry->alarm_info.mode.repeat = ALARM_REPEAT_MODE_REPEAT;
+		entry->alarm_info.mode.u_interval.interval = __bench_period();
+
+		first = now - rand() % BENCH_PERIOD_MAX;
+		localtime_r(&first, &start_tm);
+		date = &entry->alarm_info.start;
+		date->year = start_tm.tm_year + 1900;
+		date->month = start_tm.tm_mon + 1;
+		date->day = start_tm.tm_mday;
+		date->hour = start_tm.tm_hour;
+		date->min = start_tm.tm_min;
+		date->sec = start_tm.tm_sec;
+
+		_alarm_next_duetime(entry);
+		_alarm_table_add(entry);
+		_save_alarms(entry);
+	}
+
+	start = __bench_now();
+	_registry_flush();
+	__bench_report("registry", "write", nr_alarms, start);
+	_alarm_table_clear();
+
+	for (i = 0; i < G_N_ELEMENTS(modes); i++) {
+		_alarm_boot_init(modes[i], NULL);
+		_alarm_id_init();
+
+		start = __bench_now();
+		_load_alarms_from_registry();
+		__bench_report(modes[i], "load", _alarm_table_size(), start);
+
+		_alarm_table_clear();
+	}
+
+	/* the lazy mode leaves an idle callback which is not run here */
+	_alarm_boot_init(NULL, NULL);
+	db_util_close(alarmmgr_db);
+	__bench_unlink_db(path);
+
+	return 0;
+}
+
+/* a private connection to the session bus, or to the bus at address */
+static DBusConnection *__bench_bus_connect(const char *address)
+{
+	DBusConnection *connection = NULL;
+	DBusError error;
+
+	dbus_error_init(&error);
+
+	if (address == NULL) {
+		connection = dbus_bus_get_private(DBUS_BUS_SESSION, &error);
+	} else {
+		connection = dbus_connection_open_private(address, &error);
+		if (connection != NULL && !dbus_bus_register(connection,
+							     &error)) {
+			dbus_connection_close(connection);
+			dbus_connection_unref(connection);
+			connection = NULL;
+		}
+	}
+
+	if (connection == NULL) {
+		printf("bus is not connected : %s\n", error.message);
+		dbus_error_free(&error);
+		return NULL;
+	}
+
+	dbus_connection_set_exit_on_disconnect(connection, FALSE);
+
+	return connection;
+}
+
+/* the message of __alarm_send_noti_to_application() */
+static void __bench_bus_send(DBusConnection *connection,
+			     const char *service_name, alarm_id_t alarm_id)
+{
+	DBusMessage *message = NULL;
+
+	message = dbus_message_new_method_call(service_name,
+					       "/org/tizen/alarm/client",
+					       "org.tizen.alarm.client",
+					       "alarm_expired");
+	if (message == NULL)
+		return;
+
+	dbus_message_set_no_reply(message, TRUE);
+	dbus_message_set_auto_start(message, FALSE);
+	dbus_message_append_args(message, DBUS_TYPE_INT32, &alarm_id,
+				 DBUS_TYPE_INVALID);
+
+	dbus_connection_send(connection, message, NULL);
+	dbus_message_unref(message);
+}
+
+/*
+ * The application side runs in a child process. It tells its bus name, then
+ * reports when the last alarm of each batch has arrived.
+ */
+static void __bench_bus_receive(const char *address, int out)
+{
+	DBusConnection *connection = __bench_bus_connect(address);
+	DBusMessage *message = NULL;
+	const char *name = NULL;
+	char name_buf[256] = {0,};
+	double arrived;
+	int received;
+	int round;
+
+	if (connection != NULL)
+		name = dbus_bus_get_unique_name(connection);
+	if (name != NULL)
+		strncpy(name_buf, name, sizeof(name_buf) - 1);
+	if (write(out, name_buf, sizeof(name_buf)) != sizeof(name_buf)
+	    || name == NULL)
+		_exit(1);
+
+	for (round = 0; round < 2 * G_N_ELEMENTS(bench_batches); round++) {
+		received = 0;
+		while (received < bench_batches[round
+					% G_N_ELEMENTS(bench_batches)]) {
+			if (!dbus_connection_read_write(connection, -1))
+				_exit(1);
+
+			while ((message = dbus_connection_pop_message(
+					connection)) != NULL) {
+				if (dbus_message_is_method_call(message,
+						"org.tizen.alarm.client",
+						"alarm_expired"))
+					received++;
+				dbus_message_unref(message);
+			}
+		}
+
+		arrived = __bench_now();
+		if (write(out, &arrived, sizeof(arrived)) != sizeof(arrived))
+			_exit(1);
+	}
+
+	_exit(0);
+}
+
+/*
+ * Sends the alarm_expired messages of alarms expired at once, flushing
+ * the connection after every message (as the server did before) and once
+ * after the last message (the main loop drains the outgoing queue). The
+ * pass is the time the sender is busy with the messages, and delivery is
+ * the time until the last message has arrived.
+ */
+static int __bench_bus(int argc, char **argv)
+{
+	const char *address = argc > 2 ? argv[2] : NULL;
+	DBusConnection *connection = NULL;
+	char name[256];
+	int fds[2];
+	pid_t pid;
+	double start;
+	double sent;
+	double arrived;
+	int round;
+	int nr_alarms;
+	int i;
+
+	if (pipe(fds) != 0)
+		return -1;
+
+	pid = fork();
+	if (pid < 0)
+		return -1;
+	if (pid == 0) {
+		close(fds[0]);
+		__bench_bus_receive(address, fds[1]);
+	}
+	close(fds[1]);
+
+	connection = __bench_bus_connect(address);
+	if (connection == NULL
+	    || read(fds[0], name, sizeof(name)) != sizeof(name)) {
+		kill(pid, SIGKILL);
+		waitpid(pid, NULL, 0);
+		return -1;
+	}
+
+	for (round = 0; round < 2 * G_N_ELEMENTS(bench_batches); round++) {
+		bool flush_each = round < G_N_ELEMENTS(bench_batches);
+
+		nr_alarms = bench_batches[round % G_N_ELEMENTS(bench_batches)];
+
+		start = __bench_now();
+		for (i = 0; i < nr_alarms; i++) {
+			__bench_bus_send(connection, name, i + 1);
+			if (flush_each)
+				dbus_connection_flush(connection);
+		}
+		sent = __bench_now();
+		if (!flush_each)
+			dbus_connection_flush(connection);
+
+		if (read(fds[0], &arrived, sizeof(arrived))
+		    != sizeof(arrived))
+			break;
+
+		printf("%-10s %5d alarms  pass %10.1f us  delivery %10.1f us\n",
+		       flush_each ? "flush-each" : "flush-once", nr_alarms,
+		       (sent - start) * 1e6, (arrived - start) * 1e6);
+	}
+
+	waitpid(pid, NULL, 0);
+	dbus_connection_close(connection);
+	dbus_connection_unref(connection);
+
+	return 0;
+}
+
+/*
+ * The former loops of alarm-manager-schedule.c, which stepped the due time
+ * by one interval, month or year until it passed the current time. The
+ * schedule check compares them with the closed forms which replaced them.
+ * The repeat loop sets tm_isdst to -1 as the closed form does, since the
+ * uninitialized tm_isdst of the loop is a fixed bug.
+ */
+static time_t __bench_loop_repeat(__alarm_info_t *__alarm_info)
+{
+	time_t due_time = 0;
+	time_t current_time = 0;
+	struct tm duetime_tm;
+
+	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
+	alarm_date_t *start = &alarm_info->start;
+
+	time(&current_time);
+
+	duetime_tm.tm_hour = start->hour;
+	duetime_tm.tm_min = start->min;
+	duetime_tm.tm_sec = start->sec;
+	duetime_tm.tm_year = start->year - 1900;
+	duetime_tm.tm_mon = start->month - 1;
+	duetime_tm.tm_mday = start->day;
+	duetime_tm.tm_isdst = -1;
+
+	due_time = mktime(&duetime_tm);
+
+	while (__alarm_info->start > due_time || current_time >= due_time)
+		due_time += alarm_info->mode.u_interval.interval;
+
+	localtime_r(&due_time, &duetime_tm);
+
+	start->year = duetime_tm.tm_year + 1900;
+	start->month = duetime_tm.tm_mon + 1;
+	start->day = duetime_tm.tm_mday;
+	start->hour = duetime_tm.tm_hour;
+	start->min = duetime_tm.tm_min;
+	start->sec = duetime_tm.tm_sec;
+
+	return due_time;
+}
+
+/* whether mktime() moved the date the loop steps from */
+static bool __bench_loop_drifted(struct tm *duetime_tm, alarm_date_t *start)
+{
+	return duetime_tm->tm_mday != start->day
+	    || duetime_tm->tm_hour != start->hour
+	    || duetime_tm->tm_min != start->min;
+}
+
+static time_t __bench_loop_annually(__alarm_info_t *__alarm_info,
+				    bool *drifted)
+{
+	time_t due_time = 0;
+	time_t current_time = 0;
+	struct tm duetime_tm;
+
+	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
+	alarm_date_t *start = &alarm_info->start;
+
+	time(&current_time);
+	localtime_r(&current_time, &duetime_tm);
+	duetime_tm.tm_hour = start->hour;
+	duetime_tm.tm_min = start->min;
+	duetime_tm.tm_sec = start->sec;
+
+	if (start->year != 0)
+		duetime_tm.tm_year = start->year - 1900;
+
+	duetime_tm.tm_mon = start->month - 1;
+	duetime_tm.tm_mday = start->day;
+
+	due_time = mktime(&duetime_tm);
+	*drifted = __bench_loop_drifted(&duetime_tm, start);
+
+	while (__alarm_info->start > due_time || current_time > due_time) {
+		duetime_tm.tm_year += 1;
+		due_time = mktime(&duetime_tm);
+		*drifted |= __bench_loop_drifted(&duetime_tm, start);
+	}
+
+	return due_time;
+}
+
+static time_t __bench_loop_monthly(__alarm_info_t *__alarm_info,
+				   bool *drifted)
+{
+	time_t due_time = 0;
+	time_t current_time = 0;
+	struct tm duetime_tm;
+
+	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
+	alarm_date_t *start = &alarm_info->start;
+
+	time(&current_time);
+	localtime_r(&current_time, &duetime_tm);
+	duetime_tm.tm_hour = start->hour;
+	duetime_tm.tm_min = start->min;
+	duetime_tm.tm_sec = start->sec;
+
+	if (start->year != 0)
+		duetime_tm.tm_year = start->year - 1900;
+
+	if (start->month != 0)
+		duetime_tm.tm_mon = start->month - 1;
+
+	duetime_tm.tm_mday = start->day;
+
+	due_time = mktime(&duetime_tm);
+	*drifted = __bench_loop_drifted(&duetime_tm, start);
+
+	while (__alarm_info->start > due_time || current_time > due_time) {
+		duetime_tm.tm_mon += 1;
+		if (duetime_tm.tm_mon == 12) {
+			duetime_tm.tm_mon = 0;
+			duetime_tm.tm_year += 1;
+		}
+		due_time = mktime(&duetime_tm);
+		*drifted |= __bench_loop_drifted(&duetime_tm, start);
+	}
+
+	return due_time;
+}
+
+/* a start date within the last decades, or later this year */
+static void __bench_start_date(alarm_date_t *start)
+{
+	struct tm now_tm;
+
+	localtime_r(&bench_clock, &now_tm);
+	start->year = now_tm.tm_year + 1900 - rand() % 30;
+	start->month = 1 + rand() % 12;
+	start->day = 1 + rand() % 31;
+	start->hour = rand() % 24;
+	start->min = rand() % 60;
+	start->sec = rand() % 60;
+}
+
+/*
+ * Checks the closed forms of _alarm_next_duetime() against the loops they
+ * replaced, for random current times, start dates, intervals and start
+ * times, in time zones with and without DST. The repeat due times must be
+ * the same. The annual and monthly ones may differ only where the loop
+ * drifted, as described above __alarm_next_duetime_annually() and
+ * __alarm_next_duetime_monthly(). Returns non-zero on any other difference.
+ */
+static int __bench_schedule(int argc, char **argv)
+{
+	static const char *zones[] = {
+		"UTC", "Europe/Berlin", "America/Sao_Paulo",
+		"Australia/Lord_Howe",
+	};
+	static const char *modes[] = { "repeat", "annually", "monthly" };
+	int nr_cases = __bench_arg(argc, argv, 2, 100000);
+	int checked[G_N_ELEMENTS(modes)] = { 0, };
+	int drifted[G_N_ELEMENTS(modes)] = { 0, };
+	int failed[G_N_ELEMENTS(modes)] = { 0, };
+	char *saved_tz = g_strdup(g_getenv("TZ"));
+	__alarm_info_t origin;
+	__alarm_info_t loop_info;
+	__alarm_info_t closed_info;
+	alarm_date_t *start = &origin.alarm_info.start;
+	struct tm start_tm;
+	time_t interval;
+	time_t range;
+	time_t first;
+	time_t expected;
+	time_t due_time;
+	bool drift;
+	int ret = 0;
+	int mode;
+	int i;
+
+	srand(BENCH_SEED);
+
+	for (i = 0; i < nr_cases; i++) {
+		if (i % (nr_cases / G_N_ELEMENTS(zones) + 1) == 0) {
+			g_setenv("TZ", zones[i * G_N_ELEMENTS(zones)
+					     / nr_cases], TRUE);
+			tzset();
+		}
+
+		/* from 2000 to 2035 */
+		bench_clock = 946684800 + rand() % 1104537600;
+
+		memset(&origin, 0, sizeof(origin));
+		mode = rand() % G_N_ELEMENTS(modes);
+
+		if (mode == 0) {
+			/* the loop takes 150000 steps at most */
+			interval = __bench_period();
+			range = MIN(interval * 100000, 946684800);
+			first = bench_clock - rand() % range;
+			localtime_r(&first, &start_tm);
+			start->year = start_tm.tm_year + 1900;
+			start->month = start_tm.tm_mon + 1;
+			start->day = start_tm.tm_mday;
+			start->hour = start_tm.tm_hour;
+			start->min = start_tm.tm_min;
+			start->sec = start_tm.tm_sec;
+			origin.alarm_info.mode.repeat =
+			    ALARM_REPEAT_MODE_REPEAT;
+			origin.alarm_info.mode.u_interval.interval = interval;
+			if (rand() % 2)
+				origin.start = bench_clock - range / 2
+				    + rand() % range;
+		} else {
+			__bench_start_date(start);
+			if (rand() % 8 == 0)
+				start->year = 0;
+			if (mode == 2 && rand() % 8 == 0)
+				start->month = 0;
+			origin.alarm_info.mode.repeat = mode == 1 ?
+			    ALARM_REPEAT_MODE_ANNUALLY :
+			    ALARM_REPEAT_MODE_MONTHLY;
+			if (rand() % 2)
+				origin.start = bench_clock - 100000
+				    + rand() % 20000000;
+		}
+		loop_info = origin;
+		closed_info = origin;
+
+		drift = false;
+		if (mode == 0)
+			expected = __bench_loop_repeat(&loop_info);
+		else if (mode == 1)
+			expected = __bench_loop_annually(&loop_info, &drift);
+		else
+			expected = __bench_loop_monthly(&loop_info, &drift);
+		due_time = _alarm_next_duetime(&closed_info);
+
+		checked[mode]++;
+		if (due_time == expected
+		    && memcmp(&loop_info.alarm_info.start,
+			      &closed_info.alarm_info.start,
+			      sizeof(alarm_date_t)) == 0)
+			continue;
+
+		if (drift) {
+			drifted[mode]++;
+			continue;
+		}
+
+		if (failed[mode]++ < 10)
+			printf("%-8s %-10s %s now %ld start %ld "
+			       "%04d-%02d-%02d %02d:%02d:%02d "
+			       "loop %ld closed %ld\n", "schedule",
+			       modes[mode], g_getenv("TZ"), (long)bench_clock,
+			       (long)origin.start, start->year, start->month,
+			       start->day, start->hour, start->min, start->sec,
+			       (long)expected, (long)due_time);
+	}
+
+	bench_clock = 0;
+	if (saved_tz != NULL)
+		g_setenv("TZ", saved_tz, TRUE);
+	else
+		g_unsetenv("TZ");
+	tzset();
+	g_free(saved_tz);
+
+	for (mode = 0; mode < G_N_ELEMENTS(modes); mode++) {
+		printf("%-8s %-10s %9d cases %6d drifted %6d failed\n",
+		       "schedule", modes[mode], checked[mode], drifted[mode],
+		       failed[mode]);
+		if (failed[mode] > 0)
+			ret = 1;
+	}
+
+	return ret;
+}
+
+static const struct {
+	const char *name;
+	int (*run)(int argc, char **argv);
+} benches[] = {
+	{ "table", __bench_table },
+	{ "queue", __bench_queue },
+	{ "scan", __bench_scan },
+	{ "registry", __bench_registry },
+	{ "load", __bench_load },
+	{ "bus", __bench_bus },
+	{ "schedule", __bench_schedule },
+};
+
+int main(int argc, char **argv)
+{
+	int ret = 0;
+	int i;
+
+	for (i = 0; i < G_N_ELEMENTS(benches); i++) {
+		if ((argc < 2 || strcmp(argv[1], benches[i].name) == 0)
+		    && benches[i].run(argc, argv) != 0)
+			ret = 1;
+	}
+
+	return ret;
+}
@@ -47,6 +47,24 @@ bool _send_alarm_create_appsvc(alarm_context_t context, alarm_info_t *alarm_info
 			alarm_id_t *alarm_id, bundle *b,int *error_code);
 bool _send_alarm_delete(alarm_context_t context, alarm_id_t alarm_id,
 			int *error_code);
+bool _send_alarm_create_batch(alarm_context_t context, alarm_info_t **alarms,
+			int count, const char *dst_service_name,
+			const char *dst_service_name_mod, alarm_id_t *alarm_ids,
+			int *results, int *error_code);
+bool _send_alarm_delete_batch(alarm_context_t context,
+			const alarm_id_t *alarm_ids, int count, int *results,
+			int *error_code);
+bool _send_alarm_create_async(alarm_context_t context, alarm_info_t *alarm_info,
+			const char *dst_service_name,
+			const char *dst_service_name_mod,
+			alarm_result_cb_t callback, void *user_param,
+			int *error_code);
+bool _send_alarm_delete_async(alarm_context_t context, alarm_id_t alarm_id,
+			alarm_result_cb_t callback, void *user_param,
+			int *error_code);
+bool _send_alarm_get_info_async(alarm_context_t context, alarm_id_t alarm_id,
+			alarm_info_cb_t callback, void *user_param,
+			int *error_code);
 #ifdef __ALARM_BOOT
 bool _send_alarm_power_on(alarm_context_t context, bool on_off,
 			  int *error_code);
@@ -60,8 +78,84 @@ bool _send_alarm_get_number_of_ids(alarm_context_t context, int *num_of_ids,
 				   int *error_code);
 bool _send_alarm_get_info(alarm_context_t context, alarm_id_t alarm_id,
 			  alarm_info_t *alarm_info, int *error_code);
+bool _send_alarm_get_alarms(alarm_context_t context, bool first_page,
+			    int cursor, int page_size, alarm_id_t *alarm_ids,
+			    alarm_info_t *alarm_infos, int *num_of_alarms,
+			    int *next_cursor, int *error_code);
+
+
+
+/*
+ * security cookie of the process
+ *
+ * The cookie is requested from the security server and encoded only once,
+ * and the encoded cookie is kept for the following requests. It is dropped
+ * when the alarm server rejects it with ERR_ALARM_NO_PERMISSION, so that
+ * the request is sent once more with a fresh cookie.
+ */
+static char *alarm_cookie = NULL;
+G_LOCK_DEFINE_STATIC(alarm_cookie);
 
+/* returns the base64 encoded cookie of the process, to be g_free()'d */
+static char *__alarm_get_cookie(int *error_code)
+{
+	char cookie[256] = {0,};
+	char *e_cookie = NULL;
+	int size;
+
+	G_LOCK(alarm_cookie);
+
+	if (alarm_cookie == NULL) {
+		size = security_server_get_cookie_size();
+		if (size <= 0 || size > sizeof(cookie)
+		    || security_server_request_cookie(cookie, size) < 0) {
+			G_UNLOCK(alarm_cookie);
+			ALARM_MGR_EXCEPTION_PRINT(
+				"security_server_request_cookie failed\n");
+			if (error_code)
+				*error_code = -1;
+			return NULL;
+		}
+
+		alarm_cookie = g_base64_encode((const guchar *)cookie, size);
+	}
 
+	e_cookie = g_strdup(alarm_cookie);
+
+	G_UNLOCK(alarm_cookie);
+
+	if (e_cookie == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("g_base64_encode failed\n");
+		if (error_code)
+			*error_code = -1;
+	}
+
+	return e_cookie;
+}
+
+/*
+ * Drops the cached cookie when the server has rejected it. Returns true
+ * when the request should be sent again, which is done only once per
+ * request (*renewed).
+ */
+static bool __alarm_renew_cookie(int return_code, bool *renewed)
+{
+	if (return_code != ERR_ALARM_NO_PERMISSION)
+		return false;
+
+	G_LOCK(alarm_cookie);
+	g_free(alarm_cookie);
+	alarm_cookie = NULL;
+	G_UNLOCK(alarm_cookie);
+
+	if (renewed == NULL || *renewed)
+		return false;
+
+	ALARM_MGR_LOG_PRINT("cookie is rejected, it is requested again\n");
+	*renewed = true;
+
+	return true;
+}
 
 bool _send_alarm_create_appsvc(alarm_context_t context, alarm_info_t *alarm_info,
 			alarm_id_t *alarm_id, bundle *b,
@@ -70,35 +164,16 @@ bool _send_alarm_create_appsvc(alarm_context_t context, alarm_info_t *alarm_info
 	GError *error = NULL;
 	int return_code = 0;
 
-	char cookie[256] = {0,};
 	char *e_cookie = NULL;
-	int size = 0;
-	int retval = 0;
+	bool renewed = false;
 
 	bundle_raw *b_data = NULL;
 	int datalen = 0;
 
-	size = security_server_get_cookie_size();
-	retval = security_server_request_cookie(cookie, size);
-
-	if (retval < 0) {
-		ALARM_MGR_EXCEPTION_PRINT(
-			"security_server_request_cookie failed\n");
-		if (error_code)
-			*error_code = -1;	/* TODO: Need to redefine error codes */
-		return false;
-	}
-
-	e_cookie = g_base64_encode((const guchar *)cookie, size);
-
+retry:
+	e_cookie = __alarm_get_cookie(error_code);
 	if (NULL == e_cookie)
-	{
-		ALARM_MGR_EXCEPTION_PRINT(
-			"g_base64_encode failed\n");
-		if (error_code)
-			*error_code = -1;	/* TODO: Need to redefine error codes */
 		return false;
-	}
 
 	if (bundle_encode(b, &b_data, &datalen))
 	{
@@ -152,6 +227,9 @@ bool _send_alarm_create_appsvc(alarm_context_t context, alarm_info_t *alarm_info
 		b_data = NULL;
 	}
 
+	if (__alarm_renew_cookie(return_code, &renewed))
+		goto retry;
+
 	if (return_code != 0) {
 		if (error_code)
 			*error_code = return_code;
@@ -170,10 +248,8 @@ bool _send_alarm_create(alarm_context_t context, alarm_info_t *alarm_info,
 	GError *error = NULL;
 	int return_code = 0;
 
-	char cookie[256];
 	char *e_cookie;
-	int size;
-	int retval;
+	bool renewed = false;
 
 	/*TODO: Dbus bus name validation is must & will be added to avoid alarm-server crash*/
 	if (g_quark_to_string(context.quark_app_service_name) == NULL
@@ -185,16 +261,10 @@ bool _send_alarm_create(alarm_context_t context, alarm_info_t *alarm_info,
 		return false;
 	}
 
-	size = security_server_get_cookie_size();
-	retval = security_server_request_cookie(cookie, size);
-
-	if (retval < 0) {
-		ALARM_MGR_EXCEPTION_PRINT(
-			"security_server_request_cookie failed\n");
+retry:
+	e_cookie = __alarm_get_cookie(error_code);
+	if (e_cookie == NULL)
 		return false;
-	}
-
-	e_cookie = g_base64_encode((const guchar *)cookie, size);
 
 	if (!org_tizen_alarm_manager_alarm_create(context.proxy, context.pid,
 			g_quark_to_string(context.quark_app_service_name),
@@ -222,6 +292,7 @@ bool _send_alarm_create(alarm_context_t context, alarm_info_t *alarm_info,
 		"return_code[%d]\n", alarm_id, return_code);
 		ALARM_MGR_EXCEPTION_PRINT("error->message is %s\n",
 					  error->message);
+		g_free(e_cookie);
 		if (error_code)
 			*error_code = -1;	/* -1 means that system
 						   failed internally. */
@@ -230,6 +301,9 @@ bool _send_alarm_create(alarm_context_t context, alarm_info_t *alarm_info,
 
 	g_free(e_cookie);
 
+	if (__alarm_renew_cookie(return_code, &renewed))
+		goto retry;
+
 	if (return_code != 0) {
 		if (error_code)
 			*error_code = return_code;
@@ -245,36 +319,16 @@ bundle *_send_alarm_get_appsvc_info(alarm_context_t context, alarm_id_t alarm_id
 
 	bundle *b = NULL;
 
-	char cookie[256] = {0,};
 	char *e_cookie = NULL;
-	int size = 0;
-	int retval = 0;
+	bool renewed = false;
 
 	gchar *b_data = NULL;
 	int len = 0;
 
-	size = security_server_get_cookie_size();
-	retval = security_server_request_cookie(cookie, size);
-
-	if (retval < 0) {
-		ALARM_MGR_EXCEPTION_PRINT(
-			"security_server_request_cookie failed\n");
-		if (error_code)
-			*error_code = -1; /*TODO: define error*/
-		return NULL;
-	}
-
-	e_cookie = g_base64_encode((const guchar *)cookie, size);
-
+retry:
+	e_cookie = __alarm_get_cookie(error_code);
 	if (NULL == e_cookie)
-	{
-		ALARM_MGR_EXCEPTION_PRINT(
-			"g_base64_encode failed\n");
-		if (error_code)
-			*error_code = -1; /*TODO: define error*/
 		return NULL;
-	}
-
 
 	if (!org_tizen_alarm_manager_alarm_get_appsvc_info
 	    (context.proxy, context.pid, alarm_id, e_cookie, &b_data, &return_code, &error)) {
@@ -294,6 +348,13 @@ bundle *_send_alarm_get_appsvc_info(alarm_context_t context, alarm_id_t alarm_id
 		return NULL;
 	}
 
+	if (__alarm_renew_cookie(return_code, &renewed)) {
+		g_free(e_cookie);
+		g_free(b_data);
+		b_data = NULL;
+		goto retry;
+	}
+
 	if (return_code != 0){
 		if (error_code)
 			*error_code = return_code;
@@ -315,32 +376,13 @@ bool _send_alarm_set_rtc_time(alarm_context_t context, alarm_date_t *time, int *
 	GError *error = NULL;
 	int return_code = 0;
 
-	char cookie[256] = {0,};
 	char *e_cookie = NULL;
-	int size = 0;
-	int retval = 0;
-
-	size = security_server_get_cookie_size();
-	retval = security_server_request_cookie(cookie, size);
-
-	if (retval < 0) {
-		ALARM_MGR_EXCEPTION_PRINT(
-			"security_server_request_cookie failed\n");
-		if (error_code)
-			*error_code = -1; /*TODO: define error*/
-		return false;
-	}
-
-	e_cookie = g_base64_encode((const guchar *)cookie, size);
+	bool renewed = false;
 
+retry:
+	e_cookie = __alarm_get_cookie(error_code);
 	if (NULL == e_cookie)
-	{
-		ALARM_MGR_EXCEPTION_PRINT(
-			"g_base64_encode failed\n");
-		if (error_code)
-			*error_code = -1; /*TODO: define error*/
 		return false;
-	}
 
 	if (!org_tizen_alarm_manager_alarm_set_rtc_time
 	    (context.proxy, context.pid,
@@ -366,6 +408,9 @@ bool _send_alarm_set_rtc_time(alarm_context_t context, alarm_date_t *time, int *
 		e_cookie = NULL;
 	}
 
+	if (__alarm_renew_cookie(return_code, &renewed))
+		goto retry;
+
 	if (return_code != 0) {
 		if (error_code)
 			*error_code = return_code;
@@ -382,21 +427,13 @@ bool _send_alarm_delete(alarm_context_t context, alarm_id_t alarm_id,
 	GError *error = NULL;
 	int return_code = 0;
 
-	char cookie[256];
 	char *e_cookie;
-	int size;
-	int retval;
-
-	size = security_server_get_cookie_size();
-	retval = security_server_request_cookie(cookie, size);
+	bool renewed = false;
 
-	if (retval < 0) {
-		ALARM_MGR_EXCEPTION_PRINT(
-			"security_server_request_cookie failed\n");
+retry:
+	e_cookie = __alarm_get_cookie(error_code);
+	if (e_cookie == NULL)
 		return false;
-	}
-
-	e_cookie = g_base64_encode((const guchar *)cookie, size);
 
 	if (!org_tizen_alarm_manager_alarm_delete
 	    (context.proxy, context.pid, alarm_id, e_cookie, &return_code,
@@ -406,6 +443,7 @@ bool _send_alarm_delete(alarm_context_t context, alarm_id_t alarm_id,
 		ALARM_MGR_EXCEPTION_PRINT(
 		"org_tizen_alarm_manager_alarm_delete() failed. " 
 		     "alarm_id[%d], return_code[%d]\n", alarm_id, return_code);
+		g_free(e_cookie);
 		if (error_code)
 			*error_code = -1;	/*-1 means that system 
 							failed internally.*/
@@ -415,6 +453,9 @@ bool _send_alarm_delete(alarm_context_t context, alarm_id_t alarm_id,
 
 	g_free(e_cookie);
 
+	if (__alarm_renew_cookie(return_code, &renewed))
+		goto retry;
+
 	if (return_code != 0) {
 		if (error_code)
 			*error_code = return_code;
@@ -425,6 +466,424 @@ bool _send_alarm_delete(alarm_context_t context, alarm_id_t alarm_id,
 
 }
 
+/*
+ * alarm_ids and results are filled in the order of alarms. An alarm which
+ * is not created gets -1 as its id and its error code in results, and the
+ * first of these error codes is returned in error_code.
+ */
+bool _send_alarm_create_batch(alarm_context_t context, alarm_info_t **alarms,
+			int count, const char *dst_service_name,
+			const char *dst_service_name_mod, alarm_id_t *alarm_ids,
+			int *results, int *error_code)
+{
+	GError *error = NULL;
+	GArray *alarm_infos = NULL;
+	GArray *id_array = NULL;
+	GArray *result_array = NULL;
+	int return_code = 0;
+	int packed[ALARM_INFO_PACKED_LEN];
+	alarm_info_t *alarm_info = NULL;
+
+	char *e_cookie;
+	bool renewed = false;
+	int result;
+	int i;
+
+	/*TODO: Dbus bus name validation is must & will be added to avoid alarm-server crash*/
+	if (g_quark_to_string(context.quark_app_service_name) == NULL
+		&& strlen(dst_service_name) == 4
+		&& strncmp(dst_service_name, "null",4) == 0 ){
+			ALARM_MGR_EXCEPTION_PRINT("Invalid arg. Provide valid destination or call alarmmgr_init()\n");
+		if (error_code)
+			*error_code = ERR_ALARM_INVALID_PARAM;
+		return false;
+	}
+
+retry:
+	e_cookie = __alarm_get_cookie(error_code);
+	if (e_cookie == NULL)
+		return false;
+
+	alarm_infos = g_array_sized_new(false, false, sizeof(int),
+					count * ALARM_INFO_PACKED_LEN);
+	for (i = 0; i < count; i++) {
+		alarm_info = alarms[i];
+
+		packed[0] = alarm_info->start.year;
+		packed[1] = alarm_info->start.month;
+		packed[2] = alarm_info->start.day;
+		packed[3] = alarm_info->start.hour;
+		packed[4] = alarm_info->start.min;
+		packed[5] = alarm_info->start.sec;
+		packed[6] = alarm_info->end.year;
+		packed[7] = alarm_info->end.month;
+		packed[8] = alarm_info->end.day;
+		packed[9] = alarm_info->mode.u_interval.day_of_week;
+		packed[10] = alarm_info->mode.repeat;
+		packed[11] = alarm_info->alarm_type;
+		packed[12] = alarm_info->reserved_info;
+
+		g_array_append_vals(alarm_infos, packed, ALARM_INFO_PACKED_LEN);
+	}
+
+	if (!org_tizen_alarm_manager_alarm_create_batch(context.proxy,
+			context.pid,
+			g_quark_to_string(context.quark_app_service_name),
+			g_quark_to_string(context.quark_app_service_name_mod),
+			alarm_infos, dst_service_name, dst_service_name_mod,
+			e_cookie, &id_array, &result_array, &return_code,
+			&error)) {
+		/* dbus-glib error */
+		ALARM_MGR_EXCEPTION_PRINT(
+		"org_tizen_alarm_manager_alarm_create_batch() failed. "
+		"count[%d], error->message is %s\n", count,
+		error ? error->message : "unknown");
+		if (error)
+			g_error_free(error);
+		g_array_free(alarm_infos, true);
+		g_free(e_cookie);
+		if (error_code)
+			*error_code = -1;	/* -1 means that system
+						   failed internally. */
+		return false;
+	}
+
+	g_array_free(alarm_infos, true);
+	g_free(e_cookie);
+
+	if (__alarm_renew_cookie(return_code, &renewed)) {
+		if (id_array)
+			g_array_free(id_array, true);
+		if (result_array)
+			g_array_free(result_array, true);
+		id_array = NULL;
+		result_array = NULL;
+		goto retry;
+	}
+
+	for (i = 0; i < count; i++) {
+		alarm_ids[i] = id_array && i < id_array->len ?
+		    g_array_index(id_array, alarm_id_t, i) : -1;
+		result = result_array && i < result_array->len ?
+		    g_array_index(result_array, int, i) : -1;
+		if (results)
+			results[i] = result;
+		if (return_code == 0 && result != 0)
+			return_code = result;
+	}
+
+	if (id_array)
+		g_array_free(id_array, true);
+	if (result_array)
+		g_array_free(result_array, true);
+
+	if (return_code != 0) {
+		if (error_code)
+			*error_code = return_code;
+		return false;
+	}
+
+	return true;
+}
+
+/* results are filled in the order of alarm_ids, and the first error of
+   them is returned in error_code */
+bool _send_alarm_delete_batch(alarm_context_t context,
+			const alarm_id_t *alarm_ids, int count, int *results,
+			int *error_code)
+{
+	GError *error = NULL;
+	GArray *id_array = NULL;
+	GArray *result_array = NULL;
+	int return_code = 0;
+
+	char *e_cookie;
+	bool renewed = false;
+	int result;
+	int i;
+
+retry:
+	e_cookie = __alarm_get_cookie(error_code);
+	if (e_cookie == NULL)
+		return false;
+
+	id_array = g_array_sized_new(false, false, sizeof(alarm_id_t), count);
+	g_array_append_vals(id_array, alarm_ids, count);
+
+	if (!org_tizen_alarm_manager_alarm_delete_batch(context.proxy,
+			context.pid, id_array, e_cookie, &result_array,
+			&return_code, &error)) {
+		/* dbus-glib error */
+		ALARM_MGR_EXCEPTION_PRINT(
+		"org_tizen_alarm_manager_alarm_delete_batch() failed. "
+		"count[%d], error->message is %s\n", count,
+		error ? error->message : "unknown");
+		if (error)
+			g_error_free(error);
+		g_array_free(id_array, true);
+		g_free(e_cookie);
+		if (error_code)
+			*error_code = -1;	/* -1 means that system
+						   failed internally. */
+		return false;
+	}
+
+	g_array_free(id_array, true);
+	g_free(e_cookie);
+
+	if (__alarm_renew_cookie(return_code, &renewed)) {
+		if (result_array)
+			g_array_free(result_array, true);
+		result_array = NULL;
+		goto retry;
+	}
+
+	for (i = 0; i < count; i++) {
+		result = result_array && i < result_array->len ?
+		    g_array_index(result_array, int, i) : -1;
+		if (results)
+			results[i] = result;
+		if (return_code == 0 && result != 0)
+			return_code = result;
+	}
+
+	if (result_array)
+		g_array_free(result_array, true);
+
+	if (return_code != 0) {
+		if (error_code)
+			*error_code = return_code;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * asynchronous requests
+ *
+ * The request is sent with the generated *_async() stub, and the reply is
+ * handled from the main loop of the application. The state of a request is
+ * kept in __alarm_async_call_t until its reply comes.
+ */
+typedef struct {
+	alarm_id_t alarm_id;
+	alarm_result_cb_t result_cb;
+	alarm_info_cb_t info_cb;
+	void *user_param;
+} __alarm_async_call_t;
+
+/* a dbus-glib error is reported as ERR_ALARM_SYSTEM_FAIL */
+static int __alarm_async_result(const char *method, GError *error,
+				int return_code)
+{
+	if (error != NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("%s() failed. error->message is %s\n",
+					  method, error->message);
+		g_error_free(error);
+		return ERR_ALARM_SYSTEM_FAIL;
+	}
+
+	return return_code;
+}
+
+static void __alarm_create_reply(DBusGProxy *proxy, gint alarm_id,
+				 gint return_code, GError *error,
+				 gpointer userdata)
+{
+	__alarm_async_call_t *call = userdata;
+	int result;
+
+	result = __alarm_async_result("org_tizen_alarm_manager_alarm_create",
+				      error, return_code);
+	__alarm_renew_cookie(result, NULL);
+
+	if (call->result_cb)
+		call->result_cb(result == 0 ? alarm_id : -1, result,
+				call->user_param);
+
+	g_free(call);
+}
+
+static void __alarm_delete_reply(DBusGProxy *proxy, gint return_code,
+				 GError *error, gpointer userdata)
+{
+	__alarm_async_call_t *call = userdata;
+	int result;
+
+	result = __alarm_async_result("org_tizen_alarm_manager_alarm_delete",
+				      error, return_code);
+	__alarm_renew_cookie(result, NULL);
+
+	if (call->result_cb)
+		call->result_cb(call->alarm_id, result, call->user_param);
+
+	g_free(call);
+}
+
+static void __alarm_get_info_reply(DBusGProxy *proxy, gint start_year,
+				   gint start_month, gint start_day,
+				   gint start_hour, gint start_min,
+				   gint start_sec, gint end_year,
+				   gint end_month, gint end_day,
+				   gint mode_day_of_week, gint mode_repeat,
+				   gint alarm_type, gint reserved_info,
+				   gint return_code, GError *error,
+				   gpointer userdata)
+{
+	__alarm_async_call_t *call = userdata;
+	alarm_info_t alarm_info;
+	int result;
+
+	result = __alarm_async_result("org_tizen_alarm_manager_alarm_get_info",
+				      error, return_code);
+
+	memset(&alarm_info, 0, sizeof(alarm_info_t));
+	alarm_info.start.year = start_year;
+	alarm_info.start.month = start_month;
+	alarm_info.start.day = start_day;
+	alarm_info.start.hour = start_hour;
+	alarm_info.start.min = start_min;
+	alarm_info.start.sec = start_sec;
+	alarm_info.end.year = end_year;
+	alarm_info.end.month = end_month;
+	alarm_info.end.day = end_day;
+	alarm_info.mode.u_interval.day_of_week = mode_day_of_week;
+	alarm_info.mode.repeat = mode_repeat;
+	alarm_info.alarm_type = alarm_type;
+	alarm_info.reserved_info = reserved_info;
+
+	if (call->info_cb)
+		call->info_cb(call->alarm_id, result == 0 ?
+			      (alarm_entry_t *)&alarm_info : NULL, result,
+			      call->user_param);
+
+	g_free(call);
+}
+
+bool _send_alarm_create_async(alarm_context_t context, alarm_info_t *alarm_info,
+			const char *dst_service_name,
+			const char *dst_service_name_mod,
+			alarm_result_cb_t callback, void *user_param,
+			int *error_code)
+{
+	__alarm_async_call_t *call = NULL;
+	char *e_cookie = NULL;
+
+	/*TODO: Dbus bus name validation is must & will be added to avoid alarm-server crash*/
+	if (g_quark_to_string(context.quark_app_service_name) == NULL
+		&& strlen(dst_service_name) == 4
+		&& strncmp(dst_service_name, "null",4) == 0 ){
+			ALARM_MGR_EXCEPTION_PRINT("Invalid arg. Provide valid destination or call alarmmgr_init()\n");
+		if (error_code)
+			*error_code = ERR_ALARM_INVALID_PARAM;
+		return false;
+	}
+
+	e_cookie = __alarm_get_cookie(error_code);
+	if (e_cookie == NULL)
+		return false;
+
+	call = g_new0(__alarm_async_call_t, 1);
+	call->alarm_id = -1;
+	call->result_cb = callback;
+	call->user_param = user_param;
+
+	if (!org_tizen_alarm_manager_alarm_create_async(context.proxy,
+			context.pid,
+			g_quark_to_string(context.quark_app_service_name),
+			g_quark_to_string(context.quark_app_service_name_mod),
+						    alarm_info->start.year,
+						    alarm_info->start.month,
+						    alarm_info->start.day,
+						    alarm_info->start.hour,
+						    alarm_info->start.min,
+						    alarm_info->start.sec,
+						    alarm_info->end.year,
+						    alarm_info->end.month,
+						    alarm_info->end.day,
+						    alarm_info->mode.u_interval.day_of_week,
+						    alarm_info->mode.repeat,
+						    alarm_info->alarm_type,
+						    alarm_info->reserved_info,
+						    dst_service_name, dst_service_name_mod, e_cookie,
+						    __alarm_create_reply, call)) {
+		ALARM_MGR_EXCEPTION_PRINT(
+		"org_tizen_alarm_manager_alarm_create_async() failed.\n");
+		g_free(call);
+		g_free(e_cookie);
+		if (error_code)
+			*error_code = -1;	/* -1 means that system
+						   failed internally. */
+		return false;
+	}
+
+	g_free(e_cookie);
+
+	return true;
+}
+
+bool _send_alarm_delete_async(alarm_context_t context, alarm_id_t alarm_id,
+			alarm_result_cb_t callback, void *user_param,
+			int *error_code)
+{
+	__alarm_async_call_t *call = NULL;
+	char *e_cookie = NULL;
+
+	e_cookie = __alarm_get_cookie(error_code);
+	if (e_cookie == NULL)
+		return false;
+
+	call = g_new0(__alarm_async_call_t, 1);
+	call->alarm_id = alarm_id;
+	call->result_cb = callback;
+	call->user_param = user_param;
+
+	if (!org_tizen_alarm_manager_alarm_delete_async(context.proxy,
+			context.pid, alarm_id, e_cookie, __alarm_delete_reply,
+			call)) {
+		ALARM_MGR_EXCEPTION_PRINT(
+		"org_tizen_alarm_manager_alarm_delete_async() failed. "
+		     "alarm_id[%d]\n", alarm_id);
+		g_free(call);
+		g_free(e_cookie);
+		if (error_code)
+			*error_code = -1;	/*-1 means that system
+							failed internally.*/
+		return false;
+	}
+
+	g_free(e_cookie);
+
+	return true;
+}
+
+bool _send_alarm_get_info_async(alarm_context_t context, alarm_id_t alarm_id,
+			alarm_info_cb_t callback, void *user_param,
+			int *error_code)
+{
+	__alarm_async_call_t *call = NULL;
+
+	call = g_new0(__alarm_async_call_t, 1);
+	call->alarm_id = alarm_id;
+	call->info_cb = callback;
+	call->user_param = user_param;
+
+	if (!org_tizen_alarm_manager_alarm_get_info_async(context.proxy,
+			context.pid, alarm_id, __alarm_get_info_reply, call)) {
+		ALARM_MGR_EXCEPTION_PRINT(
+		"org_tizen_alarm_manager_alarm_get_info_async() failed. "
+		     "alarm_id[%d]\n", alarm_id);
+		g_free(call);
+		if (error_code)
+			*error_code = -1;	/*-1 means that system failed
+								internally.*/
+		return false;
+	}
+
+	return true;
+}
+
 #ifdef __ALARM_BOOT
 bool _send_alarm_power_on(alarm_context_t context, bool on_off,
 			   int *error_code)
@@ -620,3 +1079,84 @@ bool _send_alarm_get_info(alarm_context_t context, alarm_id_t alarm_id,
 	return true;
 
 }
+
+/*
+ * Gets a page of the alarms of the application : at most page_size alarms
+ * in the order of id, from the first alarm if first_page is true, and whose
+ * id is greater than cursor otherwise. alarm_ids and alarm_infos must have
+ * room for page_size alarms. next_cursor is 0 when there is no alarm left.
+ */
+bool _send_alarm_get_alarms(alarm_context_t context, bool first_page,
+			    int cursor, int page_size, alarm_id_t *alarm_ids,
+			    alarm_info_t *alarm_infos, int *num_of_alarms,
+			    int *next_cursor, int *error_code)
+{
+	GError *error = NULL;
+	GArray *id_array = NULL;
+	GArray *info_array = NULL;
+	int return_code = 0;
+	alarm_info_t *alarm_info = NULL;
+	int *packed;
+	int i;
+
+	*num_of_alarms = 0;
+	*next_cursor = 0;
+
+	if (!org_tizen_alarm_manager_alarm_get_alarms(context.proxy,
+			context.pid, first_page, cursor, page_size, &id_array,
+			&info_array, next_cursor, &return_code, &error)) {
+		/* dbus-glib error */
+		ALARM_MGR_EXCEPTION_PRINT(
+		"org_tizen_alarm_manager_alarm_get_alarms() failed. "
+		"cursor[%d], error->message is %s\n", cursor,
+		error ? error->message : "unknown");
+		if (error)
+			g_error_free(error);
+		if (error_code)
+			*error_code = -1;	/*-1 means that system failed
+								internally.*/
+		return false;
+	}
+
+	if (return_code == 0) {
+		for (i = 0; i < id_array->len && i < page_size
+		     && (i + 1) * ALARM_INFO_PACKED_LEN <= info_array->len;
+		     i++) {
+			packed = &g_array_index(info_array, int,
+						i * ALARM_INFO_PACKED_LEN);
+			alarm_info = &alarm_infos[i];
+
+			memset(alarm_info, 0, sizeof(alarm_info_t));
+			alarm_info->start.year = packed[0];
+			alarm_info->start.month = packed[1];
+			alarm_info->start.day = packed[2];
+			alarm_info->start.hour = packed[3];
+			alarm_info->start.min = packed[4];
+			alarm_info->start.sec = packed[5];
+			alarm_info->end.year = packed[6];
+			alarm_info->end.month = packed[7];
+			alarm_info->end.day = packed[8];
+			alarm_info->mode.u_interval.day_of_week = packed[9];
+			alarm_info->mode.repeat = packed[10];
+			alarm_info->alarm_type = packed[11];
+			alarm_info->reserved_info = packed[12];
+
+			alarm_ids[i] = g_array_index(id_array, alarm_id_t, i);
+		}
+
+		*num_of_alarms = i;
+	}
+
+	if (id_array)
+		g_array_free(id_array, true);
+	if (info_array)
+		g_array_free(info_array, true);
+
+	if (return_code != 0) {
+		if (error_code)
+			*error_code = return_code;
+		return false;
+	}
+
+	return true;
+}
@@ -52,13 +52,30 @@ static bool sub_initialized = false;
 #define MAX_OBJECT_PATH_LEN 256
 #define DBUS_NAME_FLAG_PROHIBIT_REPLACEMENT 0
 
+/* iterator of alarmmgr_enum_alarms_begin() : one page of alarms is kept */
+struct alarm_enum_t {
+	int page_size;
+	int cursor;	/* cursor of the next page, 0 if it is the last page */
+	int count;	/* the number of alarms in the page */
+	int pos;	/* the next alarm in the page */
+	alarm_id_t *alarm_ids;
+	alarm_info_t *alarm_infos;
+};
+
 static DBusHandlerResult __expire_alarm_filter(DBusConnection *connection,
 					       DBusMessage *message,
 					       void *user_data);
 static int __alarm_validate_date(alarm_date_t *date, int *error_code);
 static bool __alarm_validate_time(alarm_date_t *date, int *error_code);
+static void __alarm_get_dst_service_name(const char *destination,
+					 char *dst_service_name,
+					 char *dst_service_name_mod);
+static void __alarm_set_relative_time(alarm_info_t *alarm_info,
+				      int alarm_type, time_t trigger_at_time,
+				      time_t interval);
 static int __sub_init(void);
 static int __alarmmgr_init_appsvc(void);
+static int __alarm_enum_fetch(alarm_enum_t *iter, bool first_page);
 bool alarm_power_off(int *error_code);
 int alarmmgr_check_next_duetime(void);
 
@@ -178,6 +195,75 @@ static bool __alarm_validate_time(alarm_date_t *date, int *error_code)
 	return true;
 }
 
+/*
+ * converts destination to the dbus service names of the alarm. Both buffers
+ * must be MAX_SERVICE_NAME_LEN long and zero-filled.
+ */
+static void __alarm_get_dst_service_name(const char *destination,
+					 char *dst_service_name,
+					 char *dst_service_name_mod)
+{
+	int i;
+	int j = 0;
+
+	snprintf(dst_service_name, MAX_SERVICE_NAME_LEN, "%s", destination);
+
+	memset(dst_service_name_mod, 'a', MAX_SERVICE_NAME_LEN - 1);
+
+	for (i = 0; i <= strlen(dst_service_name); i++) {
+		if (dst_service_name[i] == '.') {
+			dst_service_name_mod[j] = dst_service_name[i];
+			j++;
+		} else {
+			dst_service_name_mod[j] = dst_service_name[i];
+		}
+		j++;
+	}
+
+	strncat(dst_service_name, ".ALARM", strlen(".ALARM"));
+	strncat(dst_service_name_mod, ".ALARM", strlen(".ALARM"));
+}
+
+/* fills alarm_info for an alarm which expires trigger_at_time sec later */
+static void __alarm_set_relative_time(alarm_info_t *alarm_info,
+				      int alarm_type, time_t trigger_at_time,
+				      time_t interval)
+{
+	time_t current_time;
+	struct tm duetime_tm;
+
+	memset(alarm_info, 0, sizeof(alarm_info_t));
+
+	alarm_info->alarm_type = alarm_type;
+	alarm_info->alarm_type |= ALARM_TYPE_RELATIVE;
+
+	time(&current_time);
+
+	current_time += trigger_at_time;
+
+	localtime_r(&current_time, &duetime_tm);
+
+	alarm_info->start.year = duetime_tm.tm_year + 1900;
+	alarm_info->start.month = duetime_tm.tm_mon + 1;
+	alarm_info->start.day = duetime_tm.tm_mday;
+
+	alarm_info->end.year = 0;
+	alarm_info->end.month = 0;
+	alarm_info->end.day = 0;
+
+	alarm_info->start.hour = duetime_tm.tm_hour;
+	alarm_info->start.min = duetime_tm.tm_min;
+	alarm_info->start.sec = duetime_tm.tm_sec;
+
+	if (interval <= 0) {
+		alarm_info->mode.repeat = ALARM_REPEAT_MODE_ONCE;
+		alarm_info->mode.u_interval.interval = 0;
+	} else {
+		alarm_info->mode.repeat = ALARM_REPEAT_MODE_REPEAT;
+		alarm_info->mode.u_interval.interval = interval;
+	}
+}
+
 static int __sub_init()
 {
 	GError *error = NULL;
@@ -675,8 +761,6 @@ EXPORT_API int alarmmgr_add_alarm_with_localtime(alarm_entry_t *alarm,
 	char dst_service_name_mod[MAX_SERVICE_NAME_LEN] = { 0 };
 	alarm_info_t *alarm_info;	/* = (alarm_info_t*)alarm; */
 	int ret;
-	int i = 0;
-	int j = 0;
 
 	if (alarm == NULL) {
 		return ERR_ALARM_INVALID_PARAM;
@@ -728,31 +812,8 @@ EXPORT_API int alarmmgr_add_alarm_with_localtime(alarm_entry_t *alarm,
 	}
 
 	if (destination != NULL) {
-		memset(dst_service_name, 0,
-		       strlen(destination) + strlen(".ALARM") + 2);
-		snprintf(dst_service_name, MAX_SERVICE_NAME_LEN, "%s",
-			 destination);
-
-		memset(dst_service_name_mod,'a',MAX_SERVICE_NAME_LEN-1);
-
-		j=0;
-
-	        for(i=0; i<=strlen(dst_service_name); i++)
-	        {
-	                if (dst_service_name[i] == '.' )
-	                {
-				dst_service_name_mod[j] = dst_service_name[i];
-	                        j++;
-	                }
-	                else
-	                {
-		                dst_service_name_mod[j] = dst_service_name[i];
-	                }
-	                j++;
-	        }
-
-		strncat(dst_service_name, ".ALARM", strlen(".ALARM"));
-		strncat(dst_service_name_mod, ".ALARM", strlen(".ALARM"));
+		__alarm_get_dst_service_name(destination, dst_service_name,
+					     dst_service_name_mod);
 
 		if (!_send_alarm_create
 		    (alarm_context, alarm_info, alarm_id, dst_service_name, dst_service_name_mod,
@@ -856,11 +917,7 @@ EXPORT_API int alarmmgr_add_alarm(int alarm_type, time_t trigger_at_time,
 {
 	char dst_service_name[MAX_SERVICE_NAME_LEN] = { 0 };
 	char dst_service_name_mod[MAX_SERVICE_NAME_LEN] = { 0 };
-	int i = 0;
-	int j = 0;
 	int error_code;
-	time_t current_time;
-	struct tm duetime_tm;
 	alarm_info_t alarm_info;
 	int ret;
 
@@ -885,69 +942,84 @@ EXPORT_API int alarmmgr_add_alarm(int alarm_type, time_t trigger_at_time,
 		return ERR_ALARM_INVALID_PARAM;
 	}
 
-	alarm_info.alarm_type = alarm_type;
-	alarm_info.alarm_type |= ALARM_TYPE_RELATIVE;
+	__alarm_set_relative_time(&alarm_info, alarm_type, trigger_at_time,
+				  interval);
 
-	time(&current_time);
+	if (destination != NULL) {
+		__alarm_get_dst_service_name(destination, dst_service_name,
+					     dst_service_name_mod);
 
-	current_time += trigger_at_time;
+		if (!_send_alarm_create
+		    (alarm_context, &alarm_info, alarm_id, dst_service_name,dst_service_name_mod,
+		     &error_code)) {
+			return error_code;
+		}
+	} else
+	    if (!_send_alarm_create
+		(alarm_context, &alarm_info, alarm_id, "null","null", &error_code)) {
+		return error_code;
+	}
 
-	localtime_r(&current_time, &duetime_tm);
+	return ALARMMGR_RESULT_SUCCESS;
+}
 
-	alarm_info.start.year = duetime_tm.tm_year + 1900;
-	alarm_info.start.month = duetime_tm.tm_mon + 1;
-	alarm_info.start.day = duetime_tm.tm_mday;
+EXPORT_API int alarmmgr_add_alarm_with_window(int alarm_type,
+					      time_t trigger_at_time,
+					      time_t window, time_t interval,
+					      const char *destination,
+					      alarm_id_t *alarm_id)
+{
+	char dst_service_name[MAX_SERVICE_NAME_LEN] = { 0 };
+	char dst_service_name_mod[MAX_SERVICE_NAME_LEN] = { 0 };
+	int error_code;
+	alarm_info_t alarm_info;
+	int ret;
 
-	alarm_info.end.year = 0;
-	alarm_info.end.month = 0;
-	alarm_info.end.day = 0;
+	ret = __sub_init();
+	if (ret < 0)
+		return ret;
 
-	alarm_info.start.hour = duetime_tm.tm_hour;
-	alarm_info.start.min = duetime_tm.tm_min;
-	alarm_info.start.sec = duetime_tm.tm_sec;
+	ALARM_MGR_LOG_PRINT("[alarm-lib]:alarm_create_with_window() is "
+			    "called\n");
 
-	if (interval <= 0) {
-		alarm_info.mode.repeat = ALARM_REPEAT_MODE_ONCE;
-		alarm_info.mode.u_interval.interval = 0;
-	} else {
-		alarm_info.mode.repeat = ALARM_REPEAT_MODE_REPEAT;
-		alarm_info.mode.u_interval.interval = interval;
+	ALARM_MGR_LOG_PRINT("interval(%d), window(%d)", interval, window);
+
+	if (alarm_id == NULL) {
+		return ERR_ALARM_INVALID_PARAM;
 	}
 
+	if (trigger_at_time < 0 || window <= 0) {
+		return ERR_ALARM_INVALID_PARAM;
+	}
+
+	if (destination && strlen(destination) >= MAX_PKG_NAME_LEN){
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-lib]: destination name is too long!\n");
+		return ERR_ALARM_INVALID_PARAM;
+	}
+
+	__alarm_set_relative_time(&alarm_info, alarm_type, trigger_at_time,
+				  interval);
+
+	if (window > ALARM_WINDOW_MAX)
+		window = ALARM_WINDOW_MAX;
+
+	/* the window is sent in reserved_info */
+	alarm_info.alarm_type |= ALARM_TYPE_INEXACT;
+	alarm_info.reserved_info = window;
+
 	if (destination != NULL) {
-		memset(dst_service_name, 0,
-		       strlen(destination) + strlen(".ALARM") + 2);
-		snprintf(dst_service_name, MAX_SERVICE_NAME_LEN, "%s",
-			 destination);
-		memset(dst_service_name_mod,'a',MAX_SERVICE_NAME_LEN-1);
-
-		j=0;
-
-	        for(i=0;i<=strlen(dst_service_name);i++)
-	        {
-	                if (dst_service_name[i] == '.')
-	                {
-	                	dst_service_name_mod[j]=dst_service_name[i];
-	                        j++;
-	                }
-	                else
-	                {
-				dst_service_name_mod[j]=dst_service_name[i];
-	                }
-	                j++;
-	        }
-
-		strncat(dst_service_name, ".ALARM", strlen(".ALARM"));
-		strncat(dst_service_name_mod, ".ALARM", strlen(".ALARM"));
+		__alarm_get_dst_service_name(destination, dst_service_name,
+					     dst_service_name_mod);
 
 		if (!_send_alarm_create
-		    (alarm_context, &alarm_info, alarm_id, dst_service_name,dst_service_name_mod,
-		     &error_code)) {
+		    (alarm_context, &alarm_info, alarm_id, dst_service_name,
+		     dst_service_name_mod, &error_code)) {
 			return error_code;
 		}
 	} else
 	    if (!_send_alarm_create
-		(alarm_context, &alarm_info, alarm_id, "null","null", &error_code)) {
+		(alarm_context, &alarm_info, alarm_id, "null", "null",
+		 &error_code)) {
 		return error_code;
 	}
 
@@ -975,62 +1047,309 @@ EXPORT_API int alarmmgr_remove_alarm(alarm_id_t alarm_id)
 	return ALARMMGR_RESULT_SUCCESS;
 }
 
-EXPORT_API int alarmmgr_enum_alarm_ids(alarm_enum_fn_t fn, void *user_param)
+EXPORT_API int alarmmgr_add_alarm_async(int alarm_type, time_t trigger_at_time,
+					time_t interval,
+					const char *destination,
+					alarm_result_cb_t callback,
+					void *user_param)
 {
-	GError *error = NULL;
-	GArray *alarm_array = NULL;
-	int return_code = 0;
-	int i = 0;
-	int maxnum_of_ids;
-	int num_of_ids;
-	int alarm_id = -1;
+	char dst_service_name[MAX_SERVICE_NAME_LEN] = { 0 };
+	char dst_service_name_mod[MAX_SERVICE_NAME_LEN] = { 0 };
+	int error_code;
+	alarm_info_t alarm_info;
 	int ret;
 
-	if (fn == NULL)
+	ret = __sub_init();
+	if (ret < 0)
+		return ret;
+
+	ALARM_MGR_LOG_PRINT("[alarm-lib]:alarm_create_async() is called\n");
+
+	if (trigger_at_time < 0) {
 		return ERR_ALARM_INVALID_PARAM;
+	}
+
+	if (destination && strlen(destination) >= MAX_PKG_NAME_LEN){
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-lib]: destination name is too long!\n");
+		return ERR_ALARM_INVALID_PARAM;
+	}
+
+	__alarm_set_relative_time(&alarm_info, alarm_type, trigger_at_time,
+				  interval);
+
+	if (destination != NULL) {
+		__alarm_get_dst_service_name(destination, dst_service_name,
+					     dst_service_name_mod);
+	} else {
+		snprintf(dst_service_name, MAX_SERVICE_NAME_LEN, "null");
+		snprintf(dst_service_name_mod, MAX_SERVICE_NAME_LEN, "null");
+	}
+
+	if (!_send_alarm_create_async(alarm_context, &alarm_info,
+				      dst_service_name, dst_service_name_mod,
+				      callback, user_param, &error_code)) {
+		return error_code;
+	}
+
+	return ALARMMGR_RESULT_SUCCESS;
+}
+
+EXPORT_API int alarmmgr_remove_alarm_async(alarm_id_t alarm_id,
+					   alarm_result_cb_t callback,
+					   void *user_param)
+{
+	int error_code;
+	int ret;
 
 	ret = __sub_init();
 	if (ret < 0)
 		return ret;
 
-	if (!org_tizen_alarm_manager_alarm_get_number_of_ids(
-	    alarm_context.proxy, alarm_context.pid, &maxnum_of_ids,
-	       &return_code, &error)) {
-		/* dbus-glib error */
-		/* error_code should be set */
-		ALARM_MGR_EXCEPTION_PRINT(
-		    "org_tizen_alarm_manager_alarm_get_number_of_ids() "
-		    "failed. return_code[%d], return_code[%s]\n",
-		return_code, error->message);
+	ALARM_MGR_LOG_PRINT("[alarm-lib]:alarm_delete_async() is called\n");
+
+	if (alarm_id <= 0) {
+		return ERR_ALARM_INVALID_ID;
 	}
 
-	if (return_code != 0) {
-		return return_code;
+	if (!_send_alarm_delete_async(alarm_context, alarm_id, callback,
+				      user_param, &error_code))
+		return error_code;
+
+	return ALARMMGR_RESULT_SUCCESS;
+}
+
+EXPORT_API int alarmmgr_get_info_async(alarm_id_t alarm_id,
+				       alarm_info_cb_t callback,
+				       void *user_param)
+{
+	int error_code;
+	int ret;
+
+	ret = __sub_init();
+	if (ret < 0)
+		return ret;
+
+	ALARM_MGR_LOG_PRINT("[alarm-lib]:alarm_get_info_async() is called\n");
+
+	if (alarm_id < 0 || callback == NULL) {
+		return ERR_ALARM_INVALID_PARAM;
 	}
 
-	if (!org_tizen_alarm_manager_alarm_get_list_of_ids(
-		     alarm_context.proxy, alarm_context.pid, maxnum_of_ids,
-	     &alarm_array, &num_of_ids, &return_code, &error)) {
-		/*dbus-glib error */
-		/* error_code should be set */
-		ALARM_MGR_EXCEPTION_PRINT(
-		    "org_tizen_alarm_manager_alarm_get_list_of_ids() "
-		    "failed. alarm_id[%d], return_code[%d]\n",
-		     alarm_id, return_code);
+	if (!_send_alarm_get_info_async(alarm_context, alarm_id, callback,
+					user_param, &error_code))
+		return error_code;
+
+	return ALARMMGR_RESULT_SUCCESS;
+}
+
+EXPORT_API int alarmmgr_add_alarms(alarm_entry_t **alarms, int count,
+				   const char *destination,
+				   alarm_id_t *alarm_ids, int *results)
+{
+	char dst_service_name[MAX_SERVICE_NAME_LEN] = { 0 };
+	char dst_service_name_mod[MAX_SERVICE_NAME_LEN] = { 0 };
+	alarm_info_t *alarm_info;
+	int error_code;
+	int ret;
+	int i;
+
+	if (alarms == NULL || alarm_ids == NULL || count <= 0
+	    || count > ALARM_BATCH_MAX) {
+		return ERR_ALARM_INVALID_PARAM;
 	}
 
-	if (return_code != 0) {
-		return return_code;
+	if (destination && strlen(destination) >= MAX_PKG_NAME_LEN){
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-lib]: destination name is too long!\n");
+		return ERR_ALARM_INVALID_PARAM;
+	}
+
+	ret = __sub_init();
+	if (ret < 0)
+		return ret;
+
+	ALARM_MGR_LOG_PRINT("[alarm-lib]:alarm_create_batch() is called, "
+			    "count(%d)\n", count);
+
+	for (i = 0; i < count; i++) {
+		alarm_info = (alarm_info_t *) alarms[i];
+		if (alarm_info == NULL) {
+			return ERR_ALARM_INVALID_PARAM;
+		}
+
+		if (alarm_info->mode.repeat >= ALARM_REPEAT_MODE_MAX) {
+			return ERR_ALARM_INVALID_PARAM;
+		}
+
+		if (!__alarm_validate_date(&alarm_info->start, &error_code)
+		    || !__alarm_validate_time(&alarm_info->start, &error_code)
+		    || !__alarm_validate_date(&alarm_info->end, &error_code)) {
+			ALARM_MGR_EXCEPTION_PRINT("alarm[%d] date or time "
+						  "error\n", i);
+			return error_code;
+		}
+	}
+
+	if (destination != NULL) {
+		__alarm_get_dst_service_name(destination, dst_service_name,
+					     dst_service_name_mod);
 	} else {
-		for (i = 0; i < alarm_array->len && i < maxnum_of_ids; i++) {
-			alarm_id = g_array_index(alarm_array, alarm_id_t, i);
-			(*fn) (alarm_id, user_param);
-			ALARM_MGR_LOG_PRINT(" alarm_id(%d)\n", alarm_id);
+		snprintf(dst_service_name, MAX_SERVICE_NAME_LEN, "null");
+		snprintf(dst_service_name_mod, MAX_SERVICE_NAME_LEN, "null");
+	}
+
+	if (!_send_alarm_create_batch(alarm_context, (alarm_info_t **)alarms,
+				      count, dst_service_name,
+				      dst_service_name_mod, alarm_ids, results,
+				      &error_code)) {
+		return error_code;
+	}
+
+	return ALARMMGR_RESULT_SUCCESS;
+}
+
+EXPORT_API int alarmmgr_remove_alarms(const alarm_id_t *alarm_ids, int count,
+				      int *results)
+{
+	int error_code;
+	int ret;
+	int i;
+
+	if (alarm_ids == NULL || count <= 0 || count > ALARM_BATCH_MAX) {
+		return ERR_ALARM_INVALID_PARAM;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (alarm_ids[i] <= 0) {
+			return ERR_ALARM_INVALID_ID;
 		}
+	}
+
+	ret = __sub_init();
+	if (ret < 0)
+		return ret;
+
+	ALARM_MGR_LOG_PRINT("[alarm-lib]:alarm_delete_batch() is called, "
+			    "count(%d)\n", count);
+
+	if (!_send_alarm_delete_batch(alarm_context, alarm_ids, count,
+				      results, &error_code))
+		return error_code;
+
+	return ALARMMGR_RESULT_SUCCESS;
+}
+
+EXPORT_API int alarmmgr_enum_alarm_ids(alarm_enum_fn_t fn, void *user_param)
+{
+	alarm_enum_t *iter = NULL;
+	alarm_id_t alarm_id = -1;
+	int ret;
+
+	if (fn == NULL)
+		return ERR_ALARM_INVALID_PARAM;
+
+	ret = alarmmgr_enum_alarms_begin(ALARM_BATCH_MAX, &iter);
+	if (ret != ALARMMGR_RESULT_SUCCESS)
+		return ret;
+
+	while ((ret = alarmmgr_enum_alarms_next(iter, &alarm_id, NULL))
+	       == ALARMMGR_RESULT_SUCCESS && alarm_id != -1) {
+		(*fn) (alarm_id, user_param);
+		ALARM_MGR_LOG_PRINT(" alarm_id(%d)\n", alarm_id);
+	}
+
+	alarmmgr_enum_alarms_end(iter);
+
+	return ret;
+}
+
+/* gets the first page of alarms, or the page after iter->cursor, into iter */
+static int __alarm_enum_fetch(alarm_enum_t *iter, bool first_page)
+{
+	int error_code;
+	int cursor = iter->cursor;
+
+	iter->count = 0;
+	iter->pos = 0;
+
+	if (!_send_alarm_get_alarms(alarm_context, first_page, cursor,
+				    iter->page_size,
+				    iter->alarm_ids, iter->alarm_infos,
+				    &iter->count, &iter->cursor,
+				    &error_code)) {
+		iter->cursor = 0;
+		return error_code;
+	}
+
+	return ALARMMGR_RESULT_SUCCESS;
+}
+
+EXPORT_API int alarmmgr_enum_alarms_begin(int page_size, alarm_enum_t **iter)
+{
+	alarm_enum_t *new_iter = NULL;
+	int ret;
+
+	if (iter == NULL || page_size < 0 || page_size > ALARM_BATCH_MAX)
+		return ERR_ALARM_INVALID_PARAM;
+
+	ret = __sub_init();
+	if (ret < 0)
+		return ret;
+
+	new_iter = g_new0(alarm_enum_t, 1);
+	new_iter->page_size = page_size > 0 ? page_size : ALARM_BATCH_MAX;
+	new_iter->alarm_ids = g_new0(alarm_id_t, new_iter->page_size);
+	new_iter->alarm_infos = g_new0(alarm_info_t, new_iter->page_size);
 
-		g_array_free(alarm_array, true);
+	ret = __alarm_enum_fetch(new_iter, true);
+	if (ret != ALARMMGR_RESULT_SUCCESS) {
+		alarmmgr_enum_alarms_end(new_iter);
+		return ret;
 	}
 
+	*iter = new_iter;
+
+	return ALARMMGR_RESULT_SUCCESS;
+}
+
+EXPORT_API int alarmmgr_enum_alarms_next(alarm_enum_t *iter,
+					 alarm_id_t *alarm_id,
+					 alarm_entry_t *alarm)
+{
+	int ret;
+
+	if (iter == NULL || alarm_id == NULL)
+		return ERR_ALARM_INVALID_PARAM;
+
+	if (iter->pos == iter->count && iter->cursor != 0) {
+		ret = __alarm_enum_fetch(iter, false);
+		if (ret != ALARMMGR_RESULT_SUCCESS)
+			return ret;
+	}
+
+	if (iter->pos == iter->count) {
+		*alarm_id = -1;
+		return ALARMMGR_RESULT_SUCCESS;
+	}
+
+	*alarm_id = iter->alarm_ids[iter->pos];
+	if (alarm != NULL) {
+		memcpy(alarm, &iter->alarm_infos[iter->pos],
+		       sizeof(alarm_info_t));
+	}
+	iter->pos++;
+
+	return ALARMMGR_RESULT_SUCCESS;
+}
+
+EXPORT_API int alarmmgr_enum_alarms_end(alarm_enum_t *iter)
+{
+	if (iter == NULL)
+		return ERR_ALARM_INVALID_PARAM;
+
+	g_free(iter->alarm_ids);
+	g_free(iter->alarm_infos);
+	g_free(iter);
+
 	return ALARMMGR_RESULT_SUCCESS;
 }
 
@@ -0,0 +1,229 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<unistd.h>
+#include<fcntl.h>
+#include<sys/types.h>
+
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * application name cache
+ *
+ * The application name of a client is the last component of the path in
+ * /proc/<pid>/cmdline. It is kept per pid with the start time of the
+ * process (/proc/<pid>/stat), which tells a reused pid from the process
+ * the name was read for.
+ *
+ * When a client leaves the bus (NameOwnerChanged), its pid may be reused,
+ * so every entry becomes stale by an epoch change. A stale entry is
+ * checked against the start time once, and the name is read again only if
+ * the process has changed. Entries of the current epoch are used without
+ * any access to /proc.
+ */
+
+#define ALARM_APP_NAME_CACHE_MAX 256
+
+typedef struct {
+	GQuark quark_app_unique_name;
+	unsigned long long start_time;
+	guint epoch;
+} __app_name_entry_t;
+
+typedef struct {
+	GHashTable *by_pid;
+	guint epoch;
+	guint hit;
+	guint miss;
+} __app_name_cache_t;
+
+static __app_name_cache_t app_name_cache = { NULL, 0, 0, 0 };
+
+static bool __app_name_read_start_time(int pid, unsigned long long *start_time)
+{
+	char proc_file[64] = { 0 };
+	char stat[512] = { 0 };
+	char *fields = NULL;
+	int fd;
+	int ret;
+
+	snprintf(proc_file, sizeof(proc_file), "/proc/%d/stat", pid);
+
+	fd = open(proc_file, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	ret = read(fd, stat, sizeof(stat) - 1);
+	close(fd);
+	if (ret <= 0)
+		return false;
+
+	/* the command name may have spaces and parentheses in it, so the
+	   fields are counted from the last ')' : state is the 3rd field and
+	   starttime is the 22nd */
+	fields = strrchr(stat, ')');
+	if (fields == NULL)
+		return false;
+
+	if (sscanf(fields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u "
+		   "%*u %*u %*d %*d %*d %*d %*d %*d %llu", start_time) != 1)
+		return false;
+
+	return true;
+}
+
+static bool __app_name_read(int pid, GQuark *quark_app_unique_name)
+{
+	char proc_file[64] = { 0 };
+	char process_name[512] = { 0 };
+	char app_name[256] = { 0 };
+	char *word = NULL;
+	char *proc_name_ptr = NULL;
+	int fd;
+	int ret;
+	int i = 0;
+
+	snprintf(proc_file, sizeof(proc_file), "/proc/%d/cmdline", pid);
+
+	fd = open(proc_file, O_RDONLY);
+	if (fd < 0) {
+		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid(%d) seems to be "
+					  "killed, so we failed to get proc file(%s) \n",
+					  pid, proc_file);
+		return false;
+	}
+
+	ret = read(fd, process_name, sizeof(process_name) - 1);
+	close(fd);
+	if (ret <= 0) {
+		ALARM_MGR_EXCEPTION_PRINT("Unable to get application name\n");
+		return false;
+	}
+
+	while (process_name[i] != '\0') {
+		if (process_name[i] == ' ') {
+			process_name[i] = '\0';
+			break;
+		}
+		i++;
+	}
+
+	word = strtok_r(process_name, "/", &proc_name_ptr);
+	while (word != NULL) {
+		snprintf(app_name, sizeof(app_name), "%s", word);
+		word = strtok_r(NULL, "/", &proc_name_ptr);
+	}
+
+	*quark_app_unique_name = g_quark_from_string(app_name);
+
+	return true;
+}
+
+/*
+ * Gets the application name of pid as a quark, which is compared with
+ * quark_app_unique_name of the alarms. Returns false if the process does
+ * not exist.
+ */
+bool _alarm_app_name_lookup(int pid, GQuark *quark_app_unique_name)
+{
+	__app_name_entry_t *entry = NULL;
+	unsigned long long start_time;
+
+	if (app_name_cache.by_pid == NULL) {
+		app_name_cache.by_pid = g_hash_table_new_full(g_direct_hash,
+						g_direct_equal, NULL, g_free);
+	}
+
+	entry = g_hash_table_lookup(app_name_cache.by_pid,
+				    GINT_TO_POINTER(pid));
+	if (entry != NULL && entry->epoch == app_name_cache.epoch) {
+		app_name_cache.hit++;
+		*quark_app_unique_name = entry->quark_app_unique_name;
+		return true;
+	}
+
+	if (!__app_name_read_start_time(pid, &start_time)) {
+		g_hash_table_remove(app_name_cache.by_pid, GINT_TO_POINTER(pid));
+		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid(%d) seems to be "
+					  "killed\n", pid);
+		return false;
+	}
+
+	if (entry != NULL && entry->start_time == start_time) {
+		app_name_cache.hit++;
+		entry->epoch = app_name_cache.epoch;
+		*quark_app_unique_name = entry->quark_app_unique_name;
+		return true;
+	}
+
+	app_name_cache.miss++;
+
+	if (!__app_name_read(pid, quark_app_unique_name)) {
+		g_hash_table_remove(app_name_cache.by_pid, GINT_TO_POINTER(pid));
+		return false;
+	}
+
+	if (entry == NULL) {
+		if (g_hash_table_size(app_name_cache.by_pid)
+		    >= ALARM_APP_NAME_CACHE_MAX)
+			g_hash_table_remove_all(app_name_cache.by_pid);
+
+		entry = g_new0(__app_name_entry_t, 1);
+		g_hash_table_insert(app_name_cache.by_pid, GINT_TO_POINTER(pid),
+				    entry);
+	}
+
+	entry->quark_app_unique_name = *quark_app_unique_name;
+	entry->start_time = start_time;
+	entry->epoch = app_name_cache.epoch;
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:app(pid:%d, name:%s) is cached, "
+			    "hit(%u), miss(%u)\n", pid,
+			    g_quark_to_string(*quark_app_unique_name),
+			    app_name_cache.hit, app_name_cache.miss);
+
+	return true;
+}
+
+/* called when a client has left the bus, since its pid may be reused */
+void _alarm_app_name_invalidate()
+{
+	app_name_cache.epoch++;
+}
+
+void _alarm_app_name_get_stats(guint *hit, guint *miss)
+{
+	if (hit)
+		*hit = app_name_cache.hit;
+	if (miss)
+		*miss = app_name_cache.miss;
+}
@@ -0,0 +1,209 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<sys/types.h>
+
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * bundle payload store
+ *
+ * The encoded bundle of an app-svc alarm may be up to MAX_BUNDLE_NAME_LEN
+ * long. Alarms registered with the same bundle share one payload, which is
+ * reference counted : an alarm holds a reference until it is freed, and a
+ * queued delivery holds one until the alarm is delivered. The payload is
+ * freed with its last reference, so the store does not grow with the
+ * bundles which are not used any more.
+ * References are taken and dropped from the dispatch threads too, so the
+ * store is guarded by a lock.
+ *
+ * The decoded form of a payload is kept with it once the payload has been
+ * delivered, so that the following expiries of a repeating alarm copy it
+ * instead of decoding the whole encoded string again. It is freed with the
+ * payload, when the last alarm using it is deleted.
+ */
+
+struct __alarm_bundle_t {
+	char *data;
+	gsize len;
+	guint ref;
+	bundle *decoded;	/*built by the first delivery*/
+};
+
+typedef struct {
+	GHashTable *payloads;	/* data -> __alarm_bundle_t */
+	guint count;
+	gsize bytes;
+} __alarm_bundle_store_t;
+
+static __alarm_bundle_store_t bundle_store = { NULL, 0, 0 };
+
+G_LOCK_DEFINE_STATIC(bundle_store);
+
+/*
+ * Returns the payload of data with a new reference. NULL and "null" mean
+ * that the alarm has no bundle, and NULL is returned for them.
+ */
+__alarm_bundle_t *_alarm_bundle_get(const char *data)
+{
+	__alarm_bundle_t *bundle = NULL;
+
+	if (data == NULL || strcmp(data, "null") == 0)
+		return NULL;
+
+	G_LOCK(bundle_store);
+
+	if (bundle_store.payloads == NULL) {
+		bundle_store.payloads = g_hash_table_new(g_str_hash,
+							 g_str_equal);
+	}
+
+	bundle = g_hash_table_lookup(bundle_store.payloads, data);
+	if (bundle != NULL) {
+		bundle->ref++;
+		G_UNLOCK(bundle_store);
+		return bundle;
+	}
+
+	bundle = g_slice_new(__alarm_bundle_t);
+	bundle->len = strlen(data);
+	bundle->data = g_strndup(data, bundle->len);
+	bundle->ref = 1;
+	bundle->decoded = NULL;
+	g_hash_table_insert(bundle_store.payloads, bundle->data, bundle);
+
+	bundle_store.count++;
+	bundle_store.bytes += bundle->len + 1;
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:bundle store : %u payloads, "
+			    "%u bytes\n", bundle_store.count,
+			    (unsigned int)bundle_store.bytes);
+
+	G_UNLOCK(bundle_store);
+
+	return bundle;
+}
+
+__alarm_bundle_t *_alarm_bundle_ref(__alarm_bundle_t *bundle)
+{
+	if (bundle == NULL)
+		return NULL;
+
+	G_LOCK(bundle_store);
+	bundle->ref++;
+	G_UNLOCK(bundle_store);
+
+	return bundle;
+}
+
+void _alarm_bundle_unref(__alarm_bundle_t *bundle)
+{
+	if (bundle == NULL)
+		return;
+
+	G_LOCK(bundle_store);
+
+	if (--bundle->ref > 0) {
+		G_UNLOCK(bundle_store);
+		return;
+	}
+
+	g_hash_table_remove(bundle_store.payloads, bundle->data);
+	bundle_store.count--;
+	bundle_store.bytes -= bundle->len + 1;
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:bundle store : %u payloads, "
+			    "%u bytes\n", bundle_store.count,
+			    (unsigned int)bundle_store.bytes);
+
+	G_UNLOCK(bundle_store);
+
+	if (bundle->decoded != NULL)
+		bundle_free(bundle->decoded);
+	g_free(bundle->data);
+	g_slice_free(__alarm_bundle_t, bundle);
+}
+
+/* returns the encoded bundle, or "null" when there is no bundle */
+const char *_alarm_bundle_data(__alarm_bundle_t *bundle)
+{
+	return bundle ? bundle->data : "null";
+}
+
+/*
+ * Returns a copy of the decoded bundle, which the caller may modify and
+ * must free with bundle_free(). The payload is decoded only the first time.
+ */
+bundle *_alarm_bundle_dup_decoded(__alarm_bundle_t *payload)
+{
+	bundle *decoded = NULL;
+	bundle *b = NULL;
+
+	if (payload == NULL)
+		return NULL;
+
+	G_LOCK(bundle_store);
+	if (payload->decoded != NULL)
+		b = bundle_dup(payload->decoded);
+	G_UNLOCK(bundle_store);
+
+	if (b != NULL)
+		return b;
+
+	/* decoded without the lock, and kept unless another thread has
+	   done it in the meantime */
+	decoded = bundle_decode((bundle_raw *)payload->data, payload->len);
+	if (decoded == NULL)
+		return NULL;
+
+	G_LOCK(bundle_store);
+	if (payload->decoded == NULL) {
+		payload->decoded = decoded;
+		decoded = NULL;
+	}
+	b = bundle_dup(payload->decoded);
+	G_UNLOCK(bundle_store);
+
+	if (decoded != NULL)
+		bundle_free(decoded);
+
+	return b;
+}
+
+void _alarm_bundle_get_stats(guint *count, gsize *bytes)
+{
+	G_LOCK(bundle_store);
+	if (count)
+		*count = bundle_store.count;
+	if (bytes)
+		*bytes = bundle_store.bytes;
+	G_UNLOCK(bundle_store);
+}
@@ -0,0 +1,269 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<time.h>
+#include<string.h>
+#include<sys/types.h>
+
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * dispatch pipeline
+ *
+ * An expired alarm is delivered by launching an application or by sending
+ * a message to it, which may take long. The main loop only queues a copy of
+ * the expired alarm (__alarm_delivery_t) and goes on with the bookkeeping.
+ * The alarms expired at once are handed to a single dispatch thread as one
+ * batch by _alarm_dispatch_flush(), and they are delivered one by one in the
+ * order they were queued : the scheduled alarm list puts the wakeup alarm
+ * first on purpose, and aul/appsvc launches must not run concurrently.
+ * Batches are delivered in the order they were flushed.
+ * _alarm_dispatch_barrier() queues a callback which is called on the main
+ * loop once the batches flushed before it have been delivered, e.g. to keep
+ * the device awake until then.
+ * When the thread is disabled or cannot be created, a batch is delivered on
+ * the main loop when it is flushed.
+ *
+ * For each alarm, the time spent in the queue and the time from queueing to
+ * the end of the delivery are accounted, and the counters are logged every
+ * DISPATCH_STATS_INTERVAL deliveries.
+ */
+
+#define DISPATCH_STATS_INTERVAL 100
+
+typedef struct {
+	const char *name;
+	unsigned int count;
+	gint64 total_usec;
+	gint64 max_usec;
+} __dispatch_stat_t;
+
+/* an item of the dispatch thread : deliveries, then a main loop callback */
+typedef struct {
+	GSList *deliveries;
+	GSourceFunc done;
+	gpointer done_data;
+} __dispatch_batch_t;
+
+typedef struct {
+	GThreadPool *pool;		/* at most one thread */
+	GSList *batch;			/* queued, not flushed yet */
+	__alarm_deliver_func_t deliver;
+	__dispatch_stat_t wait;		/* queued -> delivery started */
+	__dispatch_stat_t latency;	/* queued -> delivery finished */
+} __alarm_dispatch_t;
+
+static __alarm_dispatch_t alarm_dispatch = {
+	NULL, NULL, NULL, { "wait", 0, 0, 0 }, { "latency", 0, 0, 0 }
+};
+
+G_LOCK_DEFINE_STATIC(alarm_dispatch_stats);
+
+static void __dispatch_log_stat(__dispatch_stat_t *ds)
+{
+	ALARM_MGR_LOG_PRINT("[alarm-server]:dispatch %s : count(%u), "
+			    "avg(%" G_GINT64_FORMAT " us), "
+			    "max(%" G_GINT64_FORMAT " us)\n", ds->name,
+			    ds->count,
+			    ds->count ? ds->total_usec / ds->count : 0,
+			    ds->max_usec);
+}
+
+static void __dispatch_account(__dispatch_stat_t *ds, gint64 elapsed)
+{
+	ds->count++;
+	ds->total_usec += elapsed;
+	if (elapsed > ds->max_usec)
+		ds->max_usec = elapsed;
+}
+
+static void __dispatch_deliver(__alarm_delivery_t *delivery)
+{
+	gint64 begin = g_get_monotonic_time();
+	gint64 end;
+	bool log = false;
+
+	alarm_dispatch.deliver(delivery);
+	end = g_get_monotonic_time();
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:alarm(%d) is delivered in "
+			    "%" G_GINT64_FORMAT " us, waited %" G_GINT64_FORMAT
+			    " us\n", delivery->alarm_id,
+			    end - begin, begin - delivery->queued_usec);
+
+	G_LOCK(alarm_dispatch_stats);
+	__dispatch_account(&alarm_dispatch.wait,
+			   begin - delivery->queued_usec);
+	__dispatch_account(&alarm_dispatch.latency,
+			   end - delivery->queued_usec);
+	log = alarm_dispatch.latency.count % DISPATCH_STATS_INTERVAL == 0;
+	G_UNLOCK(alarm_dispatch_stats);
+
+	if (log)
+		_alarm_dispatch_log_stats();
+
+	_alarm_bundle_unref(delivery->bundle);
+	g_slice_free(__alarm_delivery_t, delivery);
+}
+
+/* delivers a batch in order, then hands its callback to the main loop */
+static void __dispatch_run(gpointer data, gpointer user_data)
+{
+	__dispatch_batch_t *batch = data;
+	GSList *iter = NULL;
+
+	for (iter = batch->deliveries; iter != NULL;
+	     iter = g_slist_next(iter)) {
+		__dispatch_deliver(iter->data);
+	}
+
+	if (batch->done != NULL)
+		g_idle_add(batch->done, batch->done_data);
+
+	g_slist_free(batch->deliveries);
+	g_slice_free(__dispatch_batch_t, batch);
+}
+
+static void __dispatch_queue(GSList *deliveries, GSourceFunc done,
+			     gpointer done_data)
+{
+	__dispatch_batch_t *batch = g_slice_new0(__dispatch_batch_t);
+
+	batch->deliveries = deliveries;
+	batch->done = done;
+	batch->done_data = done_data;
+
+	if (alarm_dispatch.pool == NULL) {
+		__dispatch_run(batch, NULL);
+		return;
+	}
+
+	g_thread_pool_push(alarm_dispatch.pool, batch, NULL);
+}
+
+bool _alarm_dispatch_init(bool threaded, __alarm_deliver_func_t deliver)
+{
+	GError *error = NULL;
+
+	alarm_dispatch.deliver = deliver;
+
+	if (!threaded) {
+		ALARM_MGR_LOG_PRINT("[alarm-server]:alarms are delivered on "
+				    "the main loop\n");
+		return true;
+	}
+
+	/* one thread, so that the batches are delivered in order */
+	alarm_dispatch.pool = g_thread_pool_new(__dispatch_run, NULL, 1, FALSE,
+						&error);
+	if (alarm_dispatch.pool == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:dispatch pool "
+			"creation failed(%s), alarms are delivered on the "
+			"main loop\n", error ? error->message : "");
+		if (error)
+			g_error_free(error);
+		return false;
+	}
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:alarms are delivered by the "
+			    "dispatch thread\n");
+
+	return true;
+}
+
+/*
+ * Queues an expired alarm to be delivered by the next _alarm_dispatch_flush().
+ * The fields needed to deliver it are copied, so the alarm may be
+ * rescheduled or removed right after.
+ */
+void _alarm_dispatch_push(__alarm_info_t *__alarm_info, time_t due_time)
+{
+	__alarm_delivery_t *delivery = g_slice_new0(__alarm_delivery_t);
+
+	delivery->alarm_id = __alarm_info->alarm_id;
+	delivery->pid = __alarm_info->pid;
+	delivery->quark_app_service_name =
+	    __alarm_info->quark_app_service_name;
+	delivery->quark_app_service_name_mod =
+	    __alarm_info->quark_app_service_name_mod;
+	delivery->quark_dst_service_name =
+	    __alarm_info->quark_dst_service_name;
+	delivery->quark_dst_service_name_mod =
+	    __alarm_info->quark_dst_service_name_mod;
+	delivery->bundle = _alarm_bundle_ref(__alarm_info->bundle);
+	delivery->due_time = due_time;
+	delivery->queued_usec = g_get_monotonic_time();
+
+	alarm_dispatch.batch = g_slist_prepend(alarm_dispatch.batch, delivery);
+}
+
+/* delivers the alarms queued since the last flush, as one ordered batch */
+void _alarm_dispatch_flush()
+{
+	GSList *batch = g_slist_reverse(alarm_dispatch.batch);
+
+	alarm_dispatch.batch = NULL;
+	if (batch == NULL)
+		return;
+
+	__dispatch_queue(batch, NULL, NULL);
+}
+
+/*
+ * Flushes the queued alarms, and calls done on the main loop once every
+ * batch flushed so far has been delivered.
+ */
+void _alarm_dispatch_barrier(GSourceFunc done, gpointer data)
+{
+	_alarm_dispatch_flush();
+	__dispatch_queue(NULL, done, data);
+}
+
+/* waits for the queued alarms to be delivered */
+void _alarm_dispatch_shutdown()
+{
+	_alarm_dispatch_flush();
+
+	if (alarm_dispatch.pool == NULL)
+		return;
+
+	g_thread_pool_free(alarm_dispatch.pool, FALSE, TRUE);
+	alarm_dispatch.pool = NULL;
+
+	_alarm_dispatch_log_stats();
+}
+
+void _alarm_dispatch_log_stats()
+{
+	G_LOCK(alarm_dispatch_stats);
+	__dispatch_log_stat(&alarm_dispatch.wait);
+	__dispatch_log_stat(&alarm_dispatch.latency);
+	G_UNLOCK(alarm_dispatch_stats);
+}
@@ -0,0 +1,229 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<strings.h>
+#include<limits.h>
+#include<sys/types.h>
+
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * alarm id allocator
+ *
+ * Ids are given out in increasing order from a range reserved in the
+ * registry (the ceiling). The ceiling is raised by ALARM_ID_RESERVE_CHUNK
+ * and saved before any id of the new range is used, so an id given out
+ * before a restart is never given out again as a fresh id after it.
+ * Ids of deleted alarms are kept in a bitmap, and they are reused only when
+ * the reserved range is exhausted.
+ *
+ * Alarms saved by older versions have pointer-derived ids, which may be
+ * anywhere. They are found in the alarm table and skipped.
+ */
+
+#define ALARM_ID_RESERVE_CHUNK 1024
+#define ALARM_ID_MAP_BITS 32
+
+typedef struct {
+	alarm_id_t next_id;	/* next fresh id */
+	alarm_id_t ceiling;	/* ids below the ceiling have been reserved */
+	guint32 *free_map;	/* bit set : the id below next_id is free */
+	int map_words;
+	int free_count;
+	int hint;		/* no free id in the words before the hint */
+} __alarm_id_allocator_t;
+
+static __alarm_id_allocator_t id_allocator = { 1, 1, NULL, 0, 0, 0 };
+
+static bool __id_map_reserve(alarm_id_t ceiling)
+{
+	int words = ceiling / ALARM_ID_MAP_BITS + 1;
+	guint32 *map = NULL;
+
+	if (words <= id_allocator.map_words)
+		return true;
+
+	map = realloc(id_allocator.free_map, sizeof(guint32) * words);
+	if (map == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:id map realloc "
+					  "failed\n");
+		return false;
+	}
+
+	memset(map + id_allocator.map_words, 0,
+	       sizeof(guint32) * (words - id_allocator.map_words));
+	id_allocator.free_map = map;
+	id_allocator.map_words = words;
+
+	return true;
+}
+
+static inline bool __id_is_free(alarm_id_t id)
+{
+	return id_allocator.free_map[id / ALARM_ID_MAP_BITS]
+	    & (1U << (id % ALARM_ID_MAP_BITS));
+}
+
+static void __id_set_free(alarm_id_t id, bool free_id)
+{
+	int word = id / ALARM_ID_MAP_BITS;
+	guint32 bit = 1U << (id % ALARM_ID_MAP_BITS);
+
+	if (free_id == __id_is_free(id))
+		return;
+
+	if (free_id) {
+		id_allocator.free_map[word] |= bit;
+		id_allocator.free_count++;
+		if (word < id_allocator.hint)
+			id_allocator.hint = word;
+	} else {
+		id_allocator.free_map[word] &= ~bit;
+		id_allocator.free_count--;
+	}
+}
+
+static alarm_id_t __id_take_free()
+{
+	int word;
+	alarm_id_t id;
+
+	for (word = id_allocator.hint; word < id_allocator.map_words; word++) {
+		if (id_allocator.free_map[word] != 0)
+			break;
+	}
+
+	if (word == id_allocator.map_words) {
+		id_allocator.hint = word;
+		return -1;
+	}
+
+	id_allocator.hint = word;
+	id = word * ALARM_ID_MAP_BITS + ffs(id_allocator.free_map[word]) - 1;
+	__id_set_free(id, false);
+
+	return id;
+}
+
+static bool __id_raise_ceiling()
+{
+	alarm_id_t ceiling;
+
+	if (id_allocator.ceiling > INT_MAX - ALARM_ID_RESERVE_CHUNK)
+		return false;
+
+	ceiling = id_allocator.ceiling + ALARM_ID_RESERVE_CHUNK;
+	if (!__id_map_reserve(ceiling))
+		return false;
+
+	if (!_save_alarm_id_ceiling(ceiling)) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:alarm id ceiling(%d) "
+					  "is not saved\n", ceiling);
+		return false;
+	}
+
+	id_allocator.ceiling = ceiling;
+
+	return true;
+}
+
+/*
+ * This function must be called before the alarms are loaded from the
+ * registry. Every id below the saved ceiling is free until it is marked as
+ * used by _alarm_id_mark_used().
+ */
+bool _alarm_id_init()
+{
+	alarm_id_t ceiling = 0;
+	alarm_id_t id;
+
+	if (!_load_alarm_id_ceiling(&ceiling) || ceiling < 1)
+		ceiling = 1;
+
+	free(id_allocator.free_map);
+	memset(&id_allocator, 0, sizeof(id_allocator));
+
+	if (!__id_map_reserve(ceiling))
+		return false;
+
+	id_allocator.next_id = ceiling;
+	id_allocator.ceiling = ceiling;
+
+	for (id = 1; id < ceiling; id++) {
+		__id_set_free(id, true);
+	}
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:alarm id ceiling is %d\n",
+			    ceiling);
+
+	return true;
+}
+
+void _alarm_id_mark_used(alarm_id_t alarm_id)
+{
+	if (alarm_id > 0 && alarm_id < id_allocator.next_id)
+		__id_set_free(alarm_id, false);
+}
+
+/* returns -1 when there is no id left to be given out */
+alarm_id_t _alarm_id_alloc()
+{
+	alarm_id_t id;
+
+	while (true) {
+		if (id_allocator.next_id < id_allocator.ceiling) {
+			id = id_allocator.next_id++;
+		} else if (id_allocator.free_count > 0) {
+			id = __id_take_free();
+		} else if (__id_raise_ceiling()) {
+			continue;
+		} else {
+			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:no alarm id "
+						  "is available\n");
+			return -1;
+		}
+
+		if (id < 0)
+			return -1;
+
+		/* already used by an alarm loaded from the registry */
+		if (_alarm_table_find(id) != NULL)
+			continue;
+
+		return id;
+	}
+}
+
+void _alarm_id_free(alarm_id_t alarm_id)
+{
+	if (alarm_id > 0 && alarm_id < id_allocator.next_id)
+		__id_set_free(alarm_id, true);
+}
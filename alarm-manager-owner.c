@@ -0,0 +1,160 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<sys/types.h>
+
+#include<dbus/dbus.h>
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * name owner table
+ *
+ * Before an expired alarm is delivered, the server checks whether its
+ * destination name has an owner on the bus. Asking the bus daemon costs a
+ * synchronous round trip per alarm, so the names which have an owner are
+ * kept in a table instead. The table is seeded with ListNames once the
+ * NameOwnerChanged match rule is added, and it is kept current from the
+ * NameOwnerChanged signals. It is read by the dispatch threads, so it is
+ * guarded by a lock.
+ * If the table cannot be seeded, the bus daemon is asked as before.
+ */
+
+typedef struct {
+	GHashTable *names;	/* owned name -> itself */
+	DBusConnection *connection;
+	bool seeded;
+} __alarm_name_owner_t;
+
+static __alarm_name_owner_t name_owner = { NULL, NULL, false };
+
+G_LOCK_DEFINE_STATIC(name_owner);
+
+/*
+ * This function must be called after the NameOwnerChanged signals are
+ * matched, so that no change is missed between the seed and the signals.
+ */
+bool _alarm_name_owner_init(DBusConnection *connection)
+{
+	DBusMessage *message = NULL;
+	DBusMessage *reply = NULL;
+	DBusError derror;
+	char **names = NULL;
+	int count = 0;
+	int i;
+
+	name_owner.connection = connection;
+	name_owner.names = g_hash_table_new_full(g_str_hash, g_str_equal,
+						 g_free, NULL);
+
+	message = dbus_message_new_method_call(DBUS_SERVICE_DBUS,
+					       DBUS_PATH_DBUS,
+					       DBUS_INTERFACE_DBUS,
+					       "ListNames");
+	if (message == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:ListNames message "
+					  "creation failed\n");
+		return false;
+	}
+
+	dbus_error_init(&derror);
+	reply = dbus_connection_send_with_reply_and_block(connection, message,
+							  -1, &derror);
+	dbus_message_unref(message);
+	if (reply == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:ListNames failed : "
+			"%s\n", dbus_error_is_set(&derror) ? derror.message : "");
+		dbus_error_free(&derror);
+		return false;
+	}
+
+	if (!dbus_message_get_args(reply, &derror,
+				   DBUS_TYPE_ARRAY, DBUS_TYPE_STRING,
+				   &names, &count, DBUS_TYPE_INVALID)) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:ListNames reply is "
+			"wrong : %s\n", dbus_error_is_set(&derror) ?
+			derror.message : "");
+		dbus_error_free(&derror);
+		dbus_message_unref(reply);
+		return false;
+	}
+
+	G_LOCK(name_owner);
+	for (i = 0; i < count; i++) {
+		g_hash_table_replace(name_owner.names, g_strdup(names[i]),
+				     GINT_TO_POINTER(1));
+	}
+	name_owner.seeded = true;
+	G_UNLOCK(name_owner);
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:%d names are owned on the bus\n",
+			    count);
+
+	dbus_free_string_array(names);
+	dbus_message_unref(reply);
+
+	return true;
+}
+
+/* called with the arguments of a NameOwnerChanged signal */
+void _alarm_name_owner_changed(const char *name, const char *new_owner)
+{
+	if (name == NULL || name_owner.names == NULL)
+		return;
+
+	G_LOCK(name_owner);
+	if (new_owner != NULL && new_owner[0] != '\0') {
+		g_hash_table_replace(name_owner.names, g_strdup(name),
+				     GINT_TO_POINTER(1));
+	} else {
+		g_hash_table_remove(name_owner.names, name);
+	}
+	G_UNLOCK(name_owner);
+}
+
+bool _alarm_name_has_owner(const char *name)
+{
+	bool has_owner = false;
+	bool seeded = false;
+
+	if (name == NULL)
+		return false;
+
+	G_LOCK(name_owner);
+	seeded = name_owner.seeded;
+	if (seeded)
+		has_owner = g_hash_table_lookup(name_owner.names, name) != NULL;
+	G_UNLOCK(name_owner);
+
+	if (seeded || name_owner.connection == NULL)
+		return has_owner;
+
+	return dbus_bus_name_has_owner(name_owner.connection, name, NULL);
+}
@@ -0,0 +1,170 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<sys/types.h>
+
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * fixed-size object pool
+ *
+ * Objects are carved out of slabs of objects_per_slab objects. A freed
+ * object is pushed on the free list of its pool and handed out again by the
+ * next allocation, so that the records which are created and freed on every
+ * timer expiry (alarm records, scheduled entries) do not go through malloc
+ * each time. Slabs are never given back : the memory of a pool is bounded
+ * by its high-water mark.
+ *
+ * The pools are used only from the main loop, so they are not locked.
+ */
+
+typedef struct {
+	guint in_use;		/* objects handed out and not freed */
+	guint high_water;	/* highest in_use */
+	gulong allocs;
+	gulong avoided;		/* allocations served from the free list */
+	guint slabs;
+} __alarm_pool_stats_t;
+
+typedef struct __alarm_pool_object_t {
+	struct __alarm_pool_object_t *next;
+} __alarm_pool_object_t;
+
+struct __alarm_pool_t {
+	const char *name;
+	gsize object_size;
+	guint objects_per_slab;
+	__alarm_pool_object_t *free_list;
+	GSList *slabs;
+	__alarm_pool_stats_t stats;
+};
+
+static GSList *alarm_pools = NULL;
+
+__alarm_pool_t *_alarm_pool_new(const char *name, gsize object_size,
+				guint objects_per_slab)
+{
+	__alarm_pool_t *pool = g_new0(__alarm_pool_t, 1);
+
+	if (object_size < sizeof(__alarm_pool_object_t))
+		object_size = sizeof(__alarm_pool_object_t);
+
+	/* keep every object of a slab aligned as malloc would */
+	pool->object_size = (object_size + sizeof(gdouble) - 1)
+	    & ~(sizeof(gdouble) - 1);
+	pool->objects_per_slab = objects_per_slab > 0 ? objects_per_slab : 1;
+	pool->name = name;
+
+	alarm_pools = g_slist_append(alarm_pools, pool);
+
+	return pool;
+}
+
+static bool __pool_grow(__alarm_pool_t *pool)
+{
+	char *slab = NULL;
+	guint i;
+
+	slab = malloc(pool->object_size * pool->objects_per_slab);
+	if (slab == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:%s pool slab "
+					  "malloc failed\n", pool->name);
+		return false;
+	}
+
+	/* push the objects in reverse, so that they are handed out in order */
+	for (i = pool->objects_per_slab; i > 0; i--) {
+		__alarm_pool_object_t *object = (__alarm_pool_object_t *)
+		    (slab + pool->object_size * (i - 1));
+
+		object->next = pool->free_list;
+		pool->free_list = object;
+	}
+
+	pool->slabs = g_slist_prepend(pool->slabs, slab);
+	pool->stats.slabs++;
+
+	return true;
+}
+
+/* returns a zero-filled object, or NULL when no slab can be allocated */
+gpointer _alarm_pool_alloc0(__alarm_pool_t *pool)
+{
+	__alarm_pool_object_t *object = NULL;
+
+	if (pool->free_list == NULL) {
+		if (!__pool_grow(pool))
+			return NULL;
+	} else {
+		pool->stats.avoided++;
+	}
+
+	object = pool->free_list;
+	pool->free_list = object->next;
+
+	pool->stats.allocs++;
+	pool->stats.in_use++;
+	if (pool->stats.in_use > pool->stats.high_water)
+		pool->stats.high_water = pool->stats.in_use;
+
+	memset(object, 0, pool->object_size);
+
+	return object;
+}
+
+void _alarm_pool_free(__alarm_pool_t *pool, gpointer data)
+{
+	__alarm_pool_object_t *object = data;
+
+	if (object == NULL)
+		return;
+
+	object->next = pool->free_list;
+	pool->free_list = object;
+	pool->stats.in_use--;
+}
+
+/* appends one line per pool : name in_use high_water allocs avoided slabs */
+void _alarm_pool_dump(GString *out)
+{
+	GSList *iter = NULL;
+
+	for (iter = alarm_pools; iter != NULL; iter = g_slist_next(iter)) {
+		__alarm_pool_t *pool = iter->data;
+
+		g_string_append_printf(out, "pool %s in_use=%u high_water=%u "
+				       "allocs=%lu avoided=%lu slabs=%u\n",
+				       pool->name, pool->stats.in_use,
+				       pool->stats.high_water,
+				       pool->stats.allocs, pool->stats.avoided,
+				       pool->stats.slabs);
+	}
+}
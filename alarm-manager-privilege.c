@@ -0,0 +1,168 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<sys/types.h>
+
+#include<glib.h>
+#include<security-server.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * privilege cache
+ *
+ * Checking a cookie is a synchronous request to the security server, and a
+ * client sends the same cookie with each of its requests. A granted cookie
+ * is kept for ALARM_PRIVILEGE_CACHE_TTL sec, so that the following requests
+ * carrying it are not checked again. Denied cookies are not kept : a
+ * denial may be caused by a failure of the security server itself.
+ * The cache holds at most ALARM_PRIVILEGE_CACHE_MAX cookies. When it is
+ * full, expired cookies are dropped first, and all of them otherwise.
+ */
+
+#define ALARM_PRIVILEGE_CACHE_MAX 64
+#define ALARM_PRIVILEGE_CACHE_TTL 60
+
+typedef struct {
+	GHashTable *granted;	/* encoded cookie -> expiry (usec) */
+	int call_gid;		/* -1 until the security server answers */
+} __alarm_privilege_cache_t;
+
+static __alarm_privilege_cache_t privilege_cache = { NULL, -1 };
+
+static gboolean __privilege_expired(gpointer key, gpointer value,
+				    gpointer data)
+{
+	gint64 *expiry = value;
+
+	return *expiry <= *(gint64 *)data;
+}
+
+static void __privilege_cache_add(const char *e_cookie, gint64 now)
+{
+	gint64 *expiry = NULL;
+
+	if (privilege_cache.granted == NULL) {
+		privilege_cache.granted = g_hash_table_new_full(g_str_hash,
+						g_str_equal, g_free, g_free);
+	}
+
+	if (g_hash_table_size(privilege_cache.granted)
+	    >= ALARM_PRIVILEGE_CACHE_MAX) {
+		g_hash_table_foreach_remove(privilege_cache.granted,
+					    __privilege_expired, &now);
+	}
+
+	if (g_hash_table_size(privilege_cache.granted)
+	    >= ALARM_PRIVILEGE_CACHE_MAX) {
+		g_hash_table_remove_all(privilege_cache.granted);
+	}
+
+	expiry = g_new(gint64, 1);
+	*expiry = now + (gint64)ALARM_PRIVILEGE_CACHE_TTL * G_USEC_PER_SEC;
+
+	g_hash_table_replace(privilege_cache.granted, g_strdup(e_cookie),
+			     expiry);
+}
+
+static bool __privilege_cache_lookup(const char *e_cookie, gint64 now)
+{
+	gint64 *expiry = NULL;
+
+	if (privilege_cache.granted == NULL)
+		return false;
+
+	expiry = g_hash_table_lookup(privilege_cache.granted, e_cookie);
+	if (expiry == NULL)
+		return false;
+
+	if (*expiry <= now) {
+		g_hash_table_remove(privilege_cache.granted, e_cookie);
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Returns true when the process which owns e_cookie (base64 encoded) has
+ * the "alarm" privilege.
+ */
+bool _alarm_privilege_check(const char *e_cookie)
+{
+	guchar *cookie = NULL;
+	gsize size;
+	int retval;
+	int call_gid;
+	gint64 now;
+
+	if (e_cookie == NULL)
+		return false;
+
+	now = g_get_monotonic_time();
+
+	if (__privilege_cache_lookup(e_cookie, now))
+		return true;
+
+	cookie = g_base64_decode(e_cookie, &size);
+	if (cookie == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("Unable to decode cookie!!!\n");
+		return false;
+	}
+
+	/* a failure (e.g. the security server is not up yet) is not kept,
+	   so that the gid is asked again by the next check */
+	call_gid = privilege_cache.call_gid;
+	if (call_gid < 0) {
+		call_gid = security_server_get_gid("alarm");
+		if (call_gid >= 0)
+			privilege_cache.call_gid = call_gid;
+
+		ALARM_MGR_LOG_PRINT("call_gid : %d\n", call_gid);
+	}
+
+	retval = security_server_check_privilege((const char *)cookie,
+						 call_gid);
+	g_free(cookie);
+
+	if (retval < 0) {
+		if (retval == SECURITY_SERVER_API_ERROR_ACCESS_DENIED) {
+			ALARM_MGR_EXCEPTION_PRINT("%s",
+						  "access has been denied\n");
+		}
+		ALARM_MGR_EXCEPTION_PRINT("Error has occurred in "
+					  "security_server_check_privilege()\n");
+		return false;
+	}
+
+	__privilege_cache_add(e_cookie, now);
+
+	return true;
+}
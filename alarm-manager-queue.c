@@ -0,0 +1,374 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<time.h>
+#include<string.h>
+#include<sys/types.h>
+
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * due-time queue : ordered set of the enabled alarms (due_time != 0) used by
+ * _alarm_schedule(). Two backends are provided, and one of them is selected
+ * at startup :
+ *  - "heap"  : binary min-heap (default). Each alarm keeps its position in
+ *              the heap (queue_idx), so that it can be repositioned or
+ *              removed in O(log n) when its due_time changes. The heap
+ *              nodes hold a copy of due_time next to the alarm, so that
+ *              sifting and scanning the heap read one contiguous array
+ *              instead of every alarm record.
+ *  - "wheel" : hierarchical timing wheel (alarm-manager-wheel.c), O(1)
+ *              insert/remove for many short-interval repeating alarms.
+ */
+typedef struct {
+	time_t due_time;	/* due_time of the alarm when it was queued */
+	__alarm_info_t *alarm;
+} __alarm_queue_node_t;
+
+typedef struct {
+	__alarm_queue_node_t *heap;
+	int len;
+	int size;
+} __alarm_queue_t;
+
+static __alarm_queue_t alarm_queue = { NULL, 0, 0 };
+
+static inline void __queue_set(int idx, __alarm_queue_node_t node)
+{
+	alarm_queue.heap[idx] = node;
+	node.alarm->queue_idx = idx;
+}
+
+static void __queue_sift_up(int idx)
+{
+	__alarm_queue_node_t node = alarm_queue.heap[idx];
+
+	while (idx > 0) {
+		int parent = (idx - 1) / 2;
+
+		if (alarm_queue.heap[parent].due_time <= node.due_time)
+			break;
+
+		__queue_set(idx, alarm_queue.heap[parent]);
+		idx = parent;
+	}
+
+	__queue_set(idx, node);
+}
+
+static void __queue_sift_down(int idx)
+{
+	__alarm_queue_node_t node = alarm_queue.heap[idx];
+
+	while (true) {
+		int child = idx * 2 + 1;
+
+		if (child >= alarm_queue.len)
+			break;
+
+		if (child + 1 < alarm_queue.len
+		    && alarm_queue.heap[child + 1].due_time <
+		    alarm_queue.heap[child].due_time)
+			child++;
+
+		if (node.due_time <= alarm_queue.heap[child].due_time)
+			break;
+
+		__queue_set(idx, alarm_queue.heap[child]);
+		idx = child;
+	}
+
+	__queue_set(idx, node);
+}
+
+static inline __alarm_queue_node_t __queue_node(__alarm_info_t *entry)
+{
+	__alarm_queue_node_t node = { entry->due_time, entry };
+
+	return node;
+}
+
+static bool __queue_reserve(int size)
+{
+	__alarm_queue_node_t *heap = NULL;
+	int new_size = alarm_queue.size;
+
+	if (size <= alarm_queue.size)
+		return true;
+
+	if (new_size == 0)
+		new_size = INIT_ALARM_LIST_SIZE;
+
+	while (new_size < size)
+		new_size *= 2;
+
+	heap = realloc(alarm_queue.heap,
+		       sizeof(__alarm_queue_node_t) * new_size);
+	if (heap == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:due-time queue "
+					  "realloc failed\n");
+		return false;
+	}
+
+	alarm_queue.heap = heap;
+	alarm_queue.size = new_size;
+
+	return true;
+}
+
+static bool __queue_contains(__alarm_info_t *entry)
+{
+	return entry->queue_idx >= 0 && entry->queue_idx < alarm_queue.len
+	    && alarm_queue.heap[entry->queue_idx].alarm == entry;
+}
+
+static bool __heap_init()
+{
+	alarm_queue.len = 0;
+
+	return __queue_reserve(INIT_ALARM_LIST_SIZE);
+}
+
+static void __heap_clear()
+{
+	int i;
+
+	for (i = 0; i < alarm_queue.len; i++) {
+		alarm_queue.heap[i].alarm->queue_idx = -1;
+	}
+
+	alarm_queue.len = 0;
+}
+
+static void __heap_remove(__alarm_info_t *__alarm_info)
+{
+	int idx;
+	__alarm_queue_node_t last;
+
+	if (!__queue_contains(__alarm_info))
+		return;
+
+	idx = __alarm_info->queue_idx;
+	__alarm_info->queue_idx = -1;
+
+	last = alarm_queue.heap[--alarm_queue.len];
+	if (idx == alarm_queue.len)
+		return;
+
+	__queue_set(idx, last);
+	if (idx > 0
+	    && alarm_queue.heap[(idx - 1) / 2].due_time > last.due_time)
+		__queue_sift_up(idx);
+	else
+		__queue_sift_down(idx);
+}
+
+static bool __heap_update(__alarm_info_t *__alarm_info)
+{
+	int idx;
+
+	if (__alarm_info->due_time == 0) {
+		__heap_remove(__alarm_info);
+		return true;
+	}
+
+	if (!__queue_contains(__alarm_info)) {
+		if (!__queue_reserve(alarm_queue.len + 1))
+			return false;
+
+		idx = alarm_queue.len++;
+		__queue_set(idx, __queue_node(__alarm_info));
+		__queue_sift_up(idx);
+		return true;
+	}
+
+	idx = __alarm_info->queue_idx;
+	alarm_queue.heap[idx].due_time = __alarm_info->due_time;
+	if (idx > 0 && alarm_queue.heap[(idx - 1) / 2].due_time >
+	    __alarm_info->due_time)
+		__queue_sift_up(idx);
+	else
+		__queue_sift_down(idx);
+
+	return true;
+}
+
+static __alarm_info_t *__heap_first(time_t current_time)
+{
+	__alarm_info_t *entry = NULL;
+
+	while (alarm_queue.len > 0) {
+		entry = alarm_queue.heap[0].alarm;
+		if (_alarm_deadline(entry) > current_time)
+			return entry;
+
+		ALARM_MGR_LOG_PRINT("this may be error.. alarm[%d]\n",
+				    entry->alarm_id);
+		__heap_remove(entry);
+	}
+
+	return NULL;
+}
+
+static void __queue_foreach_due(int idx, time_t due_time,
+				__alarm_queue_cb_t func, void *data)
+{
+	if (idx >= alarm_queue.len)
+		return;
+
+	if (alarm_queue.heap[idx].due_time > due_time)
+		return;
+
+	func(alarm_queue.heap[idx].alarm, data);
+
+	__queue_foreach_due(idx * 2 + 1, due_time, func, data);
+	__queue_foreach_due(idx * 2 + 2, due_time, func, data);
+}
+
+static void __heap_foreach_due(time_t due_time, __alarm_queue_cb_t func,
+			       void *data)
+{
+	__queue_foreach_due(0, due_time, func, data);
+}
+
+/* heapify all the enabled alarms of the alarm table in O(n) */
+static bool __heap_rebuild()
+{
+	__alarm_table_iter_t iter;
+	__alarm_info_t *entry = NULL;
+	int i;
+
+	__heap_clear();
+
+	if (!__queue_reserve(_alarm_table_size()))
+		return false;
+
+	_alarm_table_iter_init(&iter);
+	while (_alarm_table_iter_next(&iter, &entry)) {
+		if (entry->due_time == 0)
+			continue;
+
+		__queue_set(alarm_queue.len++, __queue_node(entry));
+	}
+
+	for (i = alarm_queue.len / 2 - 1; i >= 0; i--) {
+		__queue_sift_down(i);
+	}
+
+	return true;
+}
+
+__alarm_queue_ops_t _alarm_heap_queue_ops = {
+	.name = "heap",
+	.init = __heap_init,
+	.clear = __heap_clear,
+	.update = __heap_update,
+	.remove = __heap_remove,
+	.first = __heap_first,
+	.foreach_due = __heap_foreach_due,
+	.rebuild = __heap_rebuild,
+};
+
+static __alarm_queue_ops_t *queue_ops = &_alarm_heap_queue_ops;
+
+/*
+ * Selects the queue backend by name and initializes it. NULL or an unknown
+ * name selects the heap.
+ */
+bool _alarm_queue_init(const char *backend)
+{
+	if (backend != NULL && strcmp(backend, "wheel") == 0) {
+		queue_ops = &_alarm_wheel_queue_ops;
+	} else {
+		if (backend != NULL && strcmp(backend, "heap") != 0) {
+			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:unknown "
+				"scheduler backend(%s), heap is used\n",
+				backend);
+		}
+		queue_ops = &_alarm_heap_queue_ops;
+	}
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:scheduler backend is %s\n",
+			    queue_ops->name);
+
+	return queue_ops->init();
+}
+
+void _alarm_queue_clear()
+{
+	queue_ops->clear();
+}
+
+/*
+ * This function must be called whenever due_time of an alarm in the alarm
+ * table is changed. A disabled alarm (due_time is 0) is removed from the
+ * queue.
+ */
+bool _alarm_queue_update(__alarm_info_t *__alarm_info)
+{
+	return queue_ops->update(__alarm_info);
+}
+
+void _alarm_queue_remove(__alarm_info_t *__alarm_info)
+{
+	queue_ops->remove(__alarm_info);
+}
+
+/*
+ * Returns the alarm which will be expired first after current_time.
+ * Alarms whose deadline (see _alarm_deadline()) has already passed without
+ * being expired are not candidates to be scheduled any more, so they are
+ * dropped from the queue. An inexact alarm whose due_time has passed is kept
+ * until its window is over, and it may be returned.
+ */
+__alarm_info_t *_alarm_queue_first(time_t current_time)
+{
+	return queue_ops->first(current_time);
+}
+
+/*
+ * Calls func for every queued alarm whose due_time is not later than
+ * due_time. func must not modify the queue. The cost depends on the alarms
+ * due by due_time, not on the size of the queue.
+ */
+void _alarm_queue_foreach_due(time_t due_time, __alarm_queue_cb_t func,
+			      void *data)
+{
+	queue_ops->foreach_due(due_time, func, data);
+}
+
+/*
+ * Rebuilds the queue from the alarm table. It is used when due_time of all
+ * alarms has been recalculated at once.
+ */
+bool _alarm_queue_rebuild()
+{
+	return queue_ops->rebuild();
+}
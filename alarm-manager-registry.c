@@ -44,7 +44,8 @@
 #define SIG_TIMER 0x32
 
 #define MAX_GCONF_PATH_LEN 256
-#define MAX_QUERY_LEN 4096
+
+#define ALARM_ID_CEILING_KEY "alarm_id_ceiling"
 
 extern __alarm_server_context_t alarm_context;
 extern sqlite3 *alarmmgr_db;
@@ -56,136 +57,662 @@ extern bool enable_power_on_alarm;
 bool _save_alarms(__alarm_info_t *__alarm_info);
 bool _update_alarms(__alarm_info_t *__alarm_info);
 bool _delete_alarms(alarm_id_t alarm_id);
+bool _load_alarm_id_ceiling(alarm_id_t *ceiling);
+bool _save_alarm_id_ceiling(alarm_id_t ceiling);
+bool _registry_set_profile(const char *profile);
+bool _registry_init(guint flush_window);
+bool _registry_flush(void);
+void _registry_log_stats(void);
 #ifdef __ALARM_BOOT
 bool _update_power_on(bool on_off);
 #endif
 bool _load_alarms_from_registry(void);
 
-bool _save_alarms(__alarm_info_t *__alarm_info)
+/*
+ * Every statement of the registry is prepared once by _registry_init(), and
+ * only its parameters are bound per call.
+ */
+typedef enum {
+	REGISTRY_STMT_REPLACE,
+	REGISTRY_STMT_UPDATE_SCHEDULE,
+	REGISTRY_STMT_DELETE,
+	REGISTRY_STMT_BEGIN,
+	REGISTRY_STMT_COMMIT,
+	REGISTRY_STMT_ROLLBACK,
+	REGISTRY_STMT_SELECT_ALL,
+	REGISTRY_STMT_SELECT_META,
+	REGISTRY_STMT_SAVE_META,
+	REGISTRY_STMT_MAX
+} __registry_stmt_id_t;
+
+typedef struct {
+	const char *name;
+	const char *query;
+	sqlite3_stmt *stmt;
+	unsigned int count;
+	gint64 total_usec;
+	gint64 max_usec;
+} __registry_stmt_t;
+
+/* write-behind journal : alarm_id -> __registry_op_t */
+static GHashTable *registry_journal = NULL;
+static guint registry_flush_source = 0;
+static guint registry_flush_window = 0;	/* msec, 0 means idle */
+
+/* latency counters are logged every REGISTRY_STATS_INTERVAL executions */
+#define REGISTRY_STATS_INTERVAL 100
+
+/* msec before a failed flush is tried again, at least. A registry which
+   keeps failing must not keep the main loop busy. */
+#define REGISTRY_RETRY_WINDOW 1000
+
+static __registry_stmt_t registry_stmts[REGISTRY_STMT_MAX] = {
+	[REGISTRY_STMT_REPLACE] = { "replace",
+		"insert or replace into alarmmgr (alarm_id, start, end, pid, "
+		"app_unique_name, app_service_name, app_service_name_mod, "
+		"bundle, year, month, day, hour, min, sec, day_of_week, "
+		"repeat, alarm_type, reserved_info, dst_service_name, "
+		"dst_service_name_mod, due_time) values (?1, ?2, ?3, ?4, ?5, "
+		"?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16, ?17, ?18, "
+		"?19, ?20, ?21)" },
+	/* numbered as the replace statement, so that both are bound by
+	   __registry_bind_alarm(), but only the columns which an update
+	   request may change are written */
+	[REGISTRY_STMT_UPDATE_SCHEDULE] = { "update_schedule",
+		"update alarmmgr set start=?2, end=?3, pid=?4, "
+		"app_service_name=?6, year=?9, month=?10, day=?11, hour=?12, "
+		"min=?13, sec=?14, day_of_week=?15, repeat=?16, alarm_type=?17, "
+		"reserved_info=?18, due_time=?21 where alarm_id=?1" },
+	[REGISTRY_STMT_DELETE] = { "delete",
+		"delete from alarmmgr where alarm_id=?1" },
+	[REGISTRY_STMT_BEGIN] = { "begin", "begin immediate" },
+	[REGISTRY_STMT_COMMIT] = { "commit", "commit" },
+	[REGISTRY_STMT_ROLLBACK] = { "rollback", "rollback" },
+	[REGISTRY_STMT_SELECT_ALL] = { "select_all",
+		"select alarm_id, start, end, pid, app_unique_name, "
+		"app_service_name, app_service_name_mod, bundle, year, month, "
+		"day, hour, min, sec, day_of_week, repeat, alarm_type, "
+		"reserved_info, dst_service_name, dst_service_name_mod, "
+		"due_time from alarmmgr order by alarm_id" },
+	[REGISTRY_STMT_SELECT_META] = { "select_meta",
+		"select value from alarmmgr_meta where key=?1" },
+	[REGISTRY_STMT_SAVE_META] = { "save_meta",
+		"insert or replace into alarmmgr_meta (key, value) "
+		"values (?1, ?2)" },
+};
+
+static void __registry_log_stmt_stats(__registry_stmt_t *rs)
 {
-	char query[MAX_QUERY_LEN] = {0,};
-	char *error_message = NULL;
-	alarm_info_t *alarm_info =
-	    (alarm_info_t *) &(__alarm_info->alarm_info);
-	alarm_date_t *start = &alarm_info->start;
-	alarm_mode_t *mode = &alarm_info->mode;
+	ALARM_MGR_LOG_PRINT("[alarm-server]:registry %s : count(%u), "
+			    "avg(%" G_GINT64_FORMAT " us), "
+			    "max(%" G_GINT64_FORMAT " us)\n", rs->name,
+			    rs->count,
+			    rs->count ? rs->total_usec / rs->count : 0,
+			    rs->max_usec);
+}
 
-	snprintf(query, MAX_QUERY_LEN, "insert into alarmmgr( alarm_id, start,\
-			end, pid, app_unique_name, app_service_name, app_service_name_mod, bundle, year,\
-			month, day, hour, min, sec, day_of_week, repeat,\
-			alarm_type, reserved_info, dst_service_name, dst_service_name_mod)\
-			values (%d,%d,%d,%d,'%s','%s','%s','%s',%d,%d,%d,%d,%d,%d,%d,%d,\
-			%d,%d,'%s','%s')",\
-			__alarm_info->alarm_id,
-			(int)__alarm_info->start,
-			(int)__alarm_info->end,
-			__alarm_info->pid,
-			(char *)g_quark_to_string(
-				__alarm_info->quark_app_unique_name),
-			(char *)g_quark_to_string(
-				__alarm_info->quark_app_service_name),
-			(char *)g_quark_to_string(
-				__alarm_info->quark_app_service_name_mod),
-			(char *)g_quark_to_string(
-				__alarm_info->quark_bundle),
-			start->year,
-			start->month,
-			start->day,
-			start->hour,
-			start->min,
-			start->sec,
-			mode->u_interval.day_of_week,
-			mode->repeat,
-			alarm_info->alarm_type,
-			alarm_info->reserved_info,
-			(char *)g_quark_to_string(
-			__alarm_info->quark_dst_service_name),
-			(char *)g_quark_to_string(
-			__alarm_info->quark_dst_service_name_mod));
+static void __registry_account(__registry_stmt_t *rs, gint64 begin)
+{
+	gint64 elapsed = g_get_monotonic_time() - begin;
 
-	if (SQLITE_OK !=
-	    sqlite3_exec(alarmmgr_db, query, NULL, NULL, &error_message)) {
+	rs->count++;
+	rs->total_usec += elapsed;
+	if (elapsed > rs->max_usec)
+		rs->max_usec = elapsed;
+
+	if (rs->count % REGISTRY_STATS_INTERVAL == 0)
+		__registry_log_stmt_stats(rs);
+}
+
+/* returns the statement ready to be bound */
+static sqlite3_stmt *__registry_stmt(__registry_stmt_id_t id)
+{
+	__registry_stmt_t *rs = &registry_stmts[id];
+
+	if (rs->stmt == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("registry statement(%s) is not "
+					  "prepared\n", rs->name);
+		return NULL;
+	}
+
+	sqlite3_reset(rs->stmt);
+	sqlite3_clear_bindings(rs->stmt);
+
+	return rs->stmt;
+}
+
+/* runs a statement which does not return rows */
+static bool __registry_exec(__registry_stmt_id_t id)
+{
+	__registry_stmt_t *rs = &registry_stmts[id];
+	gint64 begin = g_get_monotonic_time();
+	int ret;
+
+	ret = sqlite3_step(rs->stmt);
+	__registry_account(rs, begin);
+	sqlite3_reset(rs->stmt);
+
+	if (ret != SQLITE_DONE) {
 		ALARM_MGR_EXCEPTION_PRINT(
-		    "Don't execute query = %s, error message = %s\n", query,
-		     error_message);
+		    "Don't execute statement = %s, error message = %s\n",
+		     rs->name, sqlite3_errmsg(alarmmgr_db));
 		return false;
 	}
 
 	return true;
 }
 
-bool _update_alarms(__alarm_info_t *__alarm_info)
+/* quark strings live as long as the process, so they are not copied */
+static void __registry_bind_quark(sqlite3_stmt *stmt, int idx, GQuark quark)
+{
+	const char *str = g_quark_to_string(quark);
+
+	sqlite3_bind_text(stmt, idx, str ? str : "null", -1, SQLITE_STATIC);
+}
+
+static void __registry_bind_alarm(sqlite3_stmt *stmt,
+				  __alarm_info_t *__alarm_info)
 {
-	char query[MAX_QUERY_LEN] = {0,};
-	char *error_message = NULL;
 	alarm_info_t *alarm_info =
 	    (alarm_info_t *) &(__alarm_info->alarm_info);
 	alarm_date_t *start = &alarm_info->start;
 	alarm_mode_t *mode = &alarm_info->mode;
 
-	snprintf(query, MAX_QUERY_LEN, "update alarmmgr set start=%d, end=%d,\
-			pid=%d, app_unique_name='%s', app_service_name='%s', app_service_name_mod='%s',\
-			bundle='%s', year=%d, month=%d, day=%d, hour=%d, min=%d, sec=%d,\
-			day_of_week=%d, repeat=%d, alarm_type=%d,\
-			reserved_info=%d, dst_service_name='%s', dst_service_name_mod='%s'\
-			where alarm_id=%d",\
-			(int)__alarm_info->start,
-			(int)__alarm_info->end,
-			__alarm_info->pid,
-			(char *)g_quark_to_string(
-				__alarm_info->quark_app_unique_name),
-			(char *)g_quark_to_string(
-				__alarm_info->quark_app_service_name),
-			(char *)g_quark_to_string(
-				__alarm_info->quark_app_service_name_mod),
-			(char *)g_quark_to_string(
-				__alarm_info->quark_bundle),
-			start->year,
-			start->month,
-			start->day,
-			start->hour,
-			start->min,
-			start->sec,
-			mode->u_interval.day_of_week,
-			mode->repeat,
-			alarm_info->alarm_type,
-			alarm_info->reserved_info,
-			(char *)g_quark_to_string(
-				__alarm_info->quark_dst_service_name),
-			(char *)g_quark_to_string(
-				__alarm_info->quark_dst_service_name_mod),
-			__alarm_info->alarm_id);
+	sqlite3_bind_int(stmt, 1, __alarm_info->alarm_id);
+	sqlite3_bind_int(stmt, 2, (int)__alarm_info->start);
+	sqlite3_bind_int(stmt, 3, (int)__alarm_info->end);
+	sqlite3_bind_int(stmt, 4, __alarm_info->pid);
+	__registry_bind_quark(stmt, 5, __alarm_info->quark_app_unique_name);
+	__registry_bind_quark(stmt, 6, __alarm_info->quark_app_service_name);
+	__registry_bind_quark(stmt, 7,
+			      __alarm_info->quark_app_service_name_mod);
+	sqlite3_bind_text(stmt, 8, _alarm_bundle_data(__alarm_info->bundle),
+			  -1, SQLITE_STATIC);
+	sqlite3_bind_int(stmt, 9, start->year);
+	sqlite3_bind_int(stmt, 10, start->month);
+	sqlite3_bind_int(stmt, 11, start->day);
+	sqlite3_bind_int(stmt, 12, start->hour);
+	sqlite3_bind_int(stmt, 13, start->min);
+	sqlite3_bind_int(stmt, 14, start->sec);
+	sqlite3_bind_int(stmt, 15, mode->u_interval.day_of_week);
+	sqlite3_bind_int(stmt, 16, mode->repeat);
+	sqlite3_bind_int(stmt, 17, alarm_info->alarm_type);
+	sqlite3_bind_int(stmt, 18, alarm_info->reserved_info);
+	__registry_bind_quark(stmt, 19, __alarm_info->quark_dst_service_name);
+	__registry_bind_quark(stmt, 20,
+			      __alarm_info->quark_dst_service_name_mod);
+	sqlite3_bind_int(stmt, 21, (int)__alarm_info->due_time);
+}
+
+/*
+ * storage profiles of the registry database
+ *  - "wal-full" : WAL journal, synchronous=FULL (default). A commit waits
+ *                 for the fsync of the WAL file only.
+ *  - "wal"      : WAL journal, synchronous=NORMAL. A commit does not wait
+ *                 for fsync. The database stays consistent, but the last
+ *                 commits may be lost on power loss.
+ *  - "rollback" : rollback journal, synchronous=FULL, as older versions.
+ * Switching the journal mode converts the database file, so the registries
+ * of older versions are migrated when they are opened with a WAL profile,
+ * and back when they are opened with "rollback".
+ */
+typedef struct {
+	const char *name;
+	const char *journal_mode;
+	int synchronous;	/* 0 : OFF, 1 : NORMAL, 2 : FULL */
+	int cache_size;		/* in pages, or in KiB if negative */
+	int mmap_size;		/* in bytes, 0 disables memory mapped I/O */
+} __registry_profile_t;
+
+static const __registry_profile_t registry_profiles[] = {
+	{ "wal-full", "wal", 2, -512, 1 << 20 },
+	{ "wal", "wal", 1, -512, 1 << 20 },
+	{ "rollback", "delete", 2, -512, 0 },
+};
+
+static int __registry_pragma_int(const char *pragma)
+{
+	char query[64] = {0,};
+	sqlite3_stmt *stmt = NULL;
+	int value = -1;
+
+	snprintf(query, sizeof(query), "pragma %s", pragma);
 
 	if (SQLITE_OK !=
-	    sqlite3_exec(alarmmgr_db, query, NULL, NULL, &error_message)) {
-		ALARM_MGR_EXCEPTION_PRINT(
-		    "Don't execute query = %s, error message = %s\n", query,
-		     error_message);
+	    sqlite3_prepare_v2(alarmmgr_db, query, -1, &stmt, NULL))
+		return -1;
+
+	if (SQLITE_ROW == sqlite3_step(stmt))
+		value = sqlite3_column_int(stmt, 0);
+
+	sqlite3_finalize(stmt);
+
+	return value;
+}
+
+static bool __registry_set_journal_mode(const char *journal_mode)
+{
+	char query[64] = {0,};
+	sqlite3_stmt *stmt = NULL;
+	const char *mode = NULL;
+	bool result = false;
+
+	snprintf(query, sizeof(query), "pragma journal_mode=%s", journal_mode);
+
+	if (SQLITE_OK !=
+	    sqlite3_prepare_v2(alarmmgr_db, query, -1, &stmt, NULL)) {
+		ALARM_MGR_EXCEPTION_PRINT("Don't prepare query = %s, "
+			"error message = %s\n", query,
+			sqlite3_errmsg(alarmmgr_db));
 		return false;
 	}
 
-	return true;
+	/* the journal mode in effect is returned, and it is left unchanged
+	   when the database cannot be converted (e.g. it is busy) */
+	if (SQLITE_ROW == sqlite3_step(stmt)) {
+		mode = (const char *)sqlite3_column_text(stmt, 0);
+		result = mode != NULL && g_ascii_strcasecmp(mode,
+							    journal_mode) == 0;
+		if (!result) {
+			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:registry "
+				"journal mode is %s, not %s\n",
+				mode ? mode : "unknown", journal_mode);
+		}
+	}
 
+	sqlite3_finalize(stmt);
+
+	return result;
 }
 
-bool _delete_alarms(alarm_id_t alarm_id)
+/*
+ * Applies a storage profile to the registry database and checks that it is
+ * in effect. NULL or an unknown name selects the default profile. The
+ * registry keeps working in whatever mode sqlite is left in, so a failure
+ * is only reported.
+ */
+bool _registry_set_profile(const char *profile)
 {
-	char query[MAX_QUERY_LEN] = {0};
+	const __registry_profile_t *rp = &registry_profiles[0];
+	char query[128] = {0,};
 	char *error_message = NULL;
+	bool result = true;
+	int i;
+
+	if (profile != NULL) {
+		for (i = 0; i < G_N_ELEMENTS(registry_profiles); i++) {
+			if (strcmp(profile, registry_profiles[i].name) == 0)
+				break;
+		}
+
+		if (i < G_N_ELEMENTS(registry_profiles))
+			rp = &registry_profiles[i];
+		else
+			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:unknown "
+				"registry profile(%s), %s is used\n", profile,
+				rp->name);
+	}
 
-	snprintf(query, MAX_QUERY_LEN, "delete from alarmmgr where alarm_id=%d",
-		 alarm_id);
+	if (!__registry_set_journal_mode(rp->journal_mode))
+		result = false;
+
+	snprintf(query, sizeof(query), "pragma synchronous=%d; "
+		 "pragma cache_size=%d; pragma mmap_size=%d", rp->synchronous,
+		 rp->cache_size, rp->mmap_size);
 
 	if (SQLITE_OK !=
 	    sqlite3_exec(alarmmgr_db, query, NULL, NULL, &error_message)) {
 		ALARM_MGR_EXCEPTION_PRINT(
 		    "Don't execute query = %s, error message = %s\n", query,
 		     error_message);
+		sqlite3_free(error_message);
+		result = false;
+	}
+
+	if (__registry_pragma_int("synchronous") != rp->synchronous
+	    || __registry_pragma_int("cache_size") != rp->cache_size) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:registry profile(%s) "
+					  "is not in effect\n", rp->name);
+		result = false;
+	}
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:registry profile is %s : "
+		"synchronous(%d), cache_size(%d), mmap_size(%d)\n", rp->name,
+		__registry_pragma_int("synchronous"),
+		__registry_pragma_int("cache_size"),
+		__registry_pragma_int("mmap_size"));
+
+	return result;
+}
+
+/*
+ * The due_time column keeps the due time of an alarm when it was written,
+ * and it is used as a hint at startup. It is added to the registries of
+ * older versions.
+ */
+static bool __registry_migrate()
+{
+	sqlite3_stmt *stmt = NULL;
+	char *error_message = NULL;
+	const char *name = NULL;
+	bool found = false;
+
+	if (SQLITE_OK != sqlite3_prepare_v2(alarmmgr_db,
+			"pragma table_info(alarmmgr)", -1, &stmt, NULL)) {
+		ALARM_MGR_EXCEPTION_PRINT("Don't prepare query = table_info, "
+			"error message = %s\n", sqlite3_errmsg(alarmmgr_db));
+		return false;
+	}
+
+	while (!found && SQLITE_ROW == sqlite3_step(stmt)) {
+		name = (const char *)sqlite3_column_text(stmt, 1);
+		found = name != NULL && strcmp(name, "due_time") == 0;
+	}
+
+	sqlite3_finalize(stmt);
+
+	if (found)
+		return true;
+
+	if (SQLITE_OK != sqlite3_exec(alarmmgr_db, "alter table alarmmgr add "
+			"column due_time integer default 0", NULL, NULL,
+			&error_message)) {
+		ALARM_MGR_EXCEPTION_PRINT("Don't add column = due_time, "
+			"error message = %s\n", error_message);
+		sqlite3_free(error_message);
+		return false;
+	}
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:due_time column is added to the "
+			    "registry\n");
+
+	return true;
+}
+
+/*
+ * This function must be called after the registry tables are created.
+ * flush_window is the write-behind window in msec. 0 means that mutations
+ * are written when the main loop becomes idle.
+ */
+bool _registry_init(guint flush_window)
+{
+	int i;
+
+	registry_flush_window = flush_window;
+
+	if (!__registry_migrate())
+		return false;
+
+	for (i = 0; i < REGISTRY_STMT_MAX; i++) {
+		if (registry_stmts[i].stmt != NULL)
+			continue;
+
+		if (SQLITE_OK !=
+		    sqlite3_prepare_v2(alarmmgr_db, registry_stmts[i].query, -1,
+				       &registry_stmts[i].stmt, NULL)) {
+			ALARM_MGR_EXCEPTION_PRINT("Don't prepare query = %s, "
+				"error message = %s\n", registry_stmts[i].query,
+				sqlite3_errmsg(alarmmgr_db));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void _registry_log_stats()
+{
+	int i;
+
+	for (i = 0; i < REGISTRY_STMT_MAX; i++) {
+		__registry_log_stmt_stats(&registry_stmts[i]);
+	}
+}
+
+/*
+ * write-behind journal
+ *
+ * Mutations are not written at once. The last operation on each alarm is
+ * kept in the journal, and the journal is written in one transaction when
+ * the main loop becomes idle, or when the write-behind window expires if a
+ * window is configured. A saved alarm is written as it is in the alarm table
+ * at that time, so several updates of an alarm cost one row write.
+ * _registry_flush() must be called before the alarm table is reloaded and
+ * before the process or the device goes down.
+ */
+typedef enum {
+	REGISTRY_OP_SAVE = 1,
+	REGISTRY_OP_UPDATE,	/* only the schedule columns have changed */
+	REGISTRY_OP_DELETE,
+} __registry_op_t;
+
+static gboolean __registry_flush_cb(gpointer user_data)
+{
+	registry_flush_source = 0;
+	_registry_flush();
+
+	return FALSE;
+}
+
+/* arms a flush after window msec, or when the main loop becomes idle if
+   window is 0, unless a flush is armed already */
+static void __registry_arm_flush(guint window)
+{
+	if (registry_flush_source != 0)
+		return;
+
+	if (window == 0)
+		registry_flush_source = g_idle_add(__registry_flush_cb, NULL);
+	else
+		registry_flush_source = g_timeout_add(window,
+						      __registry_flush_cb,
+						      NULL);
+}
+
+static bool __registry_journal(alarm_id_t alarm_id, __registry_op_t op)
+{
+	gpointer pending = NULL;
+
+	if (registry_journal == NULL) {
+		registry_journal = g_hash_table_new(g_direct_hash,
+						    g_direct_equal);
+		if (registry_journal == NULL)
+			return false;
+	}
+
+	/* an alarm saved or deleted and not written yet must be written as
+	   it is, so an update does not replace the operation */
+	pending = g_hash_table_lookup(registry_journal,
+				      GINT_TO_POINTER(alarm_id));
+	if (op == REGISTRY_OP_UPDATE && pending != NULL)
+		op = GPOINTER_TO_INT(pending);
+
+	g_hash_table_insert(registry_journal, GINT_TO_POINTER(alarm_id),
+			    GINT_TO_POINTER(op));
+
+	__registry_arm_flush(registry_flush_window);
+
+	return true;
+}
+
+static bool __registry_write(alarm_id_t alarm_id, __registry_op_t op)
+{
+	__alarm_info_t *__alarm_info = NULL;
+	sqlite3_stmt *stmt = NULL;
+
+	if (op == REGISTRY_OP_DELETE) {
+		stmt = __registry_stmt(REGISTRY_STMT_DELETE);
+		if (stmt == NULL)
+			return false;
+
+		sqlite3_bind_int(stmt, 1, alarm_id);
+		return __registry_exec(REGISTRY_STMT_DELETE);
+	}
+
+	__alarm_info = _alarm_table_find(alarm_id);
+	if (__alarm_info == NULL) {
+		/* deleted before being written */
+		return true;
+	}
+
+	if (op == REGISTRY_OP_UPDATE) {
+		stmt = __registry_stmt(REGISTRY_STMT_UPDATE_SCHEDULE);
+		if (stmt == NULL)
+			return false;
+
+		__registry_bind_alarm(stmt, __alarm_info);
+		if (!__registry_exec(REGISTRY_STMT_UPDATE_SCHEDULE))
+			return false;
+
+		/* the row is missing (e.g. its save has failed before), so
+		   the whole alarm is written */
+		if (sqlite3_changes(alarmmgr_db) > 0)
+			return true;
+	}
+
+	stmt = __registry_stmt(REGISTRY_STMT_REPLACE);
+	if (stmt == NULL)
+		return false;
+
+	__registry_bind_alarm(stmt, __alarm_info);
+
+	return __registry_exec(REGISTRY_STMT_REPLACE);
+}
+
+/*
+ * Writes the journal in one transaction. The operations which are not
+ * written are kept in the journal, and they are tried again by the next
+ * flush : all of them when the transaction fails, and the failed ones when
+ * only some rows fail. The next flush is armed on failure, so that they are
+ * written without waiting for another mutation.
+ */
+bool _registry_flush()
+{
+	GHashTableIter iter;
+	gpointer key = NULL;
+	gpointer value = NULL;
+	GSList *failed = NULL;
+	GSList *node = NULL;
+	guint count;
+	gint64 begin;
+
+	if (registry_flush_source != 0) {
+		g_source_remove(registry_flush_source);
+		registry_flush_source = 0;
+	}
+
+	if (registry_journal == NULL
+	    || g_hash_table_size(registry_journal) == 0)
+		return true;
+
+	count = g_hash_table_size(registry_journal);
+	begin = g_get_monotonic_time();
+
+	if (__registry_stmt(REGISTRY_STMT_BEGIN) == NULL
+	    || !__registry_exec(REGISTRY_STMT_BEGIN)) {
+		/* the journal is kept, and written at the next flush */
+		__registry_arm_flush(MAX(registry_flush_window,
+					 REGISTRY_RETRY_WINDOW));
+		return false;
+	}
+
+	g_hash_table_iter_init(&iter, registry_journal);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		if (!__registry_write(GPOINTER_TO_INT(key),
+				      GPOINTER_TO_INT(value))) {
+			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:alarm(%d) is "
+				"not written to the registry\n",
+				GPOINTER_TO_INT(key));
+			failed = g_slist_prepend(failed, key);
+		}
+	}
+
+	if (__registry_stmt(REGISTRY_STMT_COMMIT) == NULL
+	    || !__registry_exec(REGISTRY_STMT_COMMIT)) {
+		if (__registry_stmt(REGISTRY_STMT_ROLLBACK) != NULL)
+			__registry_exec(REGISTRY_STMT_ROLLBACK);
+		g_slist_free(failed);
+		__registry_arm_flush(MAX(registry_flush_window,
+					 REGISTRY_RETRY_WINDOW));
+		return false;
+	}
+
+	/* only the failed operations are left in the journal */
+	g_hash_table_iter_init(&iter, registry_journal);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		for (node = failed; node != NULL; node = g_slist_next(node)) {
+			if (node->data == key)
+				break;
+		}
+
+		if (node == NULL)
+			g_hash_table_iter_remove(&iter);
+	}
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:registry flush : %u alarms, "
+			    "%u failed, %" G_GINT64_FORMAT " us\n", count,
+			    g_slist_length(failed),
+			    g_get_monotonic_time() - begin);
+
+	if (failed != NULL) {
+		g_slist_free(failed);
+		__registry_arm_flush(MAX(registry_flush_window,
+					 REGISTRY_RETRY_WINDOW));
 		return false;
 	}
 
 	return true;
+}
 
+bool _save_alarms(__alarm_info_t *__alarm_info)
+{
+	return __registry_journal(__alarm_info->alarm_id, REGISTRY_OP_SAVE);
+}
+
+/* writes only the schedule columns (see REGISTRY_STMT_UPDATE_SCHEDULE) */
+bool _update_alarms(__alarm_info_t *__alarm_info)
+{
+	return __registry_journal(__alarm_info->alarm_id, REGISTRY_OP_UPDATE);
+}
+
+bool _delete_alarms(alarm_id_t alarm_id)
+{
+	return __registry_journal(alarm_id, REGISTRY_OP_DELETE);
+}
+
+/* *ceiling is left unchanged when no ceiling has been saved yet */
+bool _load_alarm_id_ceiling(alarm_id_t *ceiling)
+{
+	__registry_stmt_t *rs = &registry_stmts[REGISTRY_STMT_SELECT_META];
+	sqlite3_stmt *stmt = __registry_stmt(REGISTRY_STMT_SELECT_META);
+	gint64 begin = g_get_monotonic_time();
+
+	if (stmt == NULL)
+		return false;
+
+	sqlite3_bind_text(stmt, 1, ALARM_ID_CEILING_KEY, -1, SQLITE_STATIC);
+
+	if (SQLITE_ROW == sqlite3_step(stmt)) {
+		*ceiling = sqlite3_column_int(stmt, 0);
+	}
+
+	__registry_account(rs, begin);
+	sqlite3_reset(stmt);
+
+	return true;
+}
+
+bool _save_alarm_id_ceiling(alarm_id_t ceiling)
+{
+	sqlite3_stmt *stmt = __registry_stmt(REGISTRY_STMT_SAVE_META);
+
+	if (stmt == NULL)
+		return false;
+
+	sqlite3_bind_text(stmt, 1, ALARM_ID_CEILING_KEY, -1, SQLITE_STATIC);
+	sqlite3_bind_int(stmt, 2, ceiling);
+
+	return __registry_exec(REGISTRY_STMT_SAVE_META);
 }
 
 #ifdef __ALARM_BOOT
@@ -220,22 +747,36 @@ bool _update_power_on(bool on_off)
 }
 #endif
 
+/* interns a text column without copying it to a local buffer first */
+static GQuark __registry_column_quark(sqlite3_stmt *stmt, int idx)
+{
+	const char *str = (const char *)sqlite3_column_text(stmt, idx);
+
+	return g_quark_from_string(str ? str : "null");
+}
+
+/*
+ * Loads every alarm saved in the registry. The rows are decoded straight
+ * into alarm records, and the records are added to the alarm table without
+ * being queued one by one. The due-time queue is built once after the last
+ * row, which costs O(n) instead of O(n log n).
+ */
 bool _load_alarms_from_registry()
 {
-	int i = 0;
-	char query[MAX_QUERY_LEN] = {0,};
+	int count = 0;
+	int duplicated = 0;
 	sqlite3_stmt *stmt = NULL;
-	const char *tail = NULL;
+	gint64 begin;
+	gint64 mark;
+	gint64 read_usec = 0;
+	gint64 duetime_usec = 0;
+	gint64 table_usec = 0;
+	gint64 queue_usec = 0;
+	gint64 schedule_usec = 0;
 	alarm_info_t *alarm_info = NULL;
 	__alarm_info_t *__alarm_info = NULL;
 	alarm_date_t *start = NULL;
 	alarm_mode_t *mode = NULL;
-	char app_unique_name[MAX_SERVICE_NAME_LEN] = {0,};
-	char app_service_name[MAX_SERVICE_NAME_LEN] = {0,};
-	char app_service_name_mod[MAX_SERVICE_NAME_LEN] = {0,};
-	char dst_service_name[MAX_SERVICE_NAME_LEN] = {0,};
-	char dst_service_name_mod[MAX_SERVICE_NAME_LEN] = {0,};
-	char bundle[MAX_BUNDLE_NAME_LEN] = {0,};
 
 #ifdef __ALARM_BOOT
 	/*sprintf(path, "/Services/AlarmMgr/Auto_poweron"); */
@@ -244,42 +785,36 @@ bool _load_alarms_from_registry()
 	/*gconf_client_get_bool(pGCC, path, NULL); */
 #endif
 
-	snprintf(query, MAX_QUERY_LEN, "select * from alarmmgr");
-
-	if (SQLITE_OK !=
-	    sqlite3_prepare(alarmmgr_db, query, strlen(query), &stmt, &tail)) {
-		ALARM_MGR_EXCEPTION_PRINT("sqlite3_prepare error\n");
+	stmt = __registry_stmt(REGISTRY_STMT_SELECT_ALL);
+	if (stmt == NULL) {
 		return false;
 	}
-
-	for (i = 0; SQLITE_ROW == sqlite3_step(stmt); i++) {
-		__alarm_info = malloc(sizeof(__alarm_info_t));
-
-		if (G_UNLIKELY(__alarm_info == NULL)){
-			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:Malloc failed\n");
-			return false;
+	begin = g_get_monotonic_time();
+	mark = begin;
+
+	while (SQLITE_ROW == sqlite3_step(stmt)) {
+		__alarm_info = _alarm_info_new();
+		if (__alarm_info == NULL) {
+			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:alarm record "
+				"allocation failed, loading is stopped\n");
+			break;
 		}
 		alarm_info = (alarm_info_t *) &(__alarm_info->alarm_info);
 		start = &alarm_info->start;
 		mode = &alarm_info->mode;
 
-		memset(app_service_name, 0, MAX_SERVICE_NAME_LEN);
-		memset(app_service_name_mod, 0, MAX_SERVICE_NAME_LEN);
-		memset(dst_service_name, 0, MAX_SERVICE_NAME_LEN);
-		memset(dst_service_name_mod, 0, MAX_SERVICE_NAME_LEN);
-
 		__alarm_info->alarm_id = sqlite3_column_int(stmt, 0);
 		__alarm_info->start = sqlite3_column_int(stmt, 1);
 		__alarm_info->end = sqlite3_column_int(stmt, 2);
 		__alarm_info->pid = sqlite3_column_int(stmt, 3);
-		strncpy(app_unique_name, (const char *)sqlite3_column_text(stmt, 4),
-			MAX_SERVICE_NAME_LEN - 1);
-		strncpy(app_service_name, (const char *)sqlite3_column_text(stmt, 5),
-			MAX_SERVICE_NAME_LEN - 1);
-		strncpy(app_service_name_mod, (const char *)sqlite3_column_text(stmt, 6),
-			MAX_SERVICE_NAME_LEN - 1);
-		strncpy(bundle, (const char *)sqlite3_column_text(stmt, 7),
-			MAX_BUNDLE_NAME_LEN - 1);		
+		__alarm_info->quark_app_unique_name =
+		    __registry_column_quark(stmt, 4);
+		__alarm_info->quark_app_service_name =
+		    __registry_column_quark(stmt, 5);
+		__alarm_info->quark_app_service_name_mod =
+		    __registry_column_quark(stmt, 6);
+		__alarm_info->bundle = _alarm_bundle_get(
+			(const char *)sqlite3_column_text(stmt, 7));
 		start->year = sqlite3_column_int(stmt, 8);
 		start->month = sqlite3_column_int(stmt, 9);
 		start->day = sqlite3_column_int(stmt, 10);
@@ -290,34 +825,52 @@ bool _load_alarms_from_registry()
 		mode->repeat = sqlite3_column_int(stmt, 15);
 		alarm_info->alarm_type = sqlite3_column_int(stmt, 16);
 		alarm_info->reserved_info = sqlite3_column_int(stmt, 17);
-		strncpy(dst_service_name, (const char *)sqlite3_column_text(stmt, 18),
-			MAX_SERVICE_NAME_LEN - 1);
-		strncpy(dst_service_name_mod, (const char *)sqlite3_column_text(stmt, 19),
-			MAX_SERVICE_NAME_LEN - 1);
-
-		__alarm_info->quark_app_unique_name =
-		    g_quark_from_string(app_unique_name);
-		__alarm_info->quark_app_service_name =
-		    g_quark_from_string(app_service_name);
-		__alarm_info->quark_app_service_name_mod=
-		    g_quark_from_string(app_service_name_mod);
 		__alarm_info->quark_dst_service_name =
-		    g_quark_from_string(dst_service_name);
-		__alarm_info->quark_dst_service_name_mod=
-		    g_quark_from_string(dst_service_name_mod);
-		__alarm_info->quark_bundle = g_quark_from_string(bundle);
-
-		_alarm_next_duetime(__alarm_info);
-		alarm_context.alarms =
-		    g_slist_append(alarm_context.alarms, __alarm_info);
-	}
+		    __registry_column_quark(stmt, 18);
+		__alarm_info->quark_dst_service_name_mod =
+		    __registry_column_quark(stmt, 19);
+
+		read_usec += g_get_monotonic_time() - mark;
+		mark = g_get_monotonic_time();
+
+		_alarm_boot_duetime(__alarm_info,
+				    sqlite3_column_int(stmt, 20));
+
+		duetime_usec += g_get_monotonic_time() - mark;
+		mark = g_get_monotonic_time();
+
+		if (!_alarm_table_load(__alarm_info)) {
+			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:alarm(%d) is "
+				"already loaded\n", __alarm_info->alarm_id);
+			_alarm_info_free(__alarm_info);
+			duplicated++;
+		} else {
+			_alarm_id_mark_used(__alarm_info->alarm_id);
+			count++;
+		}
 
-	if (SQLITE_OK != sqlite3_finalize(stmt)) {
-		ALARM_MGR_EXCEPTION_PRINT("error : sqlite3_finalize\n");
-		return false;
+		table_usec += g_get_monotonic_time() - mark;
+		mark = g_get_monotonic_time();
 	}
 
-	_alarm_schedule();
+	__registry_account(&registry_stmts[REGISTRY_STMT_SELECT_ALL], begin);
+	sqlite3_reset(stmt);
+
+	mark = g_get_monotonic_time();
+	_alarm_queue_rebuild();
+	queue_usec = g_get_monotonic_time() - mark;
+
+	mark = g_get_monotonic_time();
+	_alarm_boot_schedule();
+	schedule_usec = g_get_monotonic_time() - mark;
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:%d alarms are loaded(%d duplicated) "
+		"in %" G_GINT64_FORMAT " us : read(%" G_GINT64_FORMAT " us), "
+		"due_time(%" G_GINT64_FORMAT " us), "
+		"table(%" G_GINT64_FORMAT " us), queue(%" G_GINT64_FORMAT " us), "
+		"schedule(%" G_GINT64_FORMAT " us)\n", count, duplicated,
+		g_get_monotonic_time() - begin, read_usec, duetime_usec,
+		table_usec, queue_usec, schedule_usec);
 
 	return true;
 }
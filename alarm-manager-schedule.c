@@ -52,7 +52,7 @@ static time_t __alarm_next_duetime_repeat(__alarm_info_t *__alarm_info);
 static time_t __alarm_next_duetime_annually(__alarm_info_t *__alarm_info);
 static time_t __alarm_next_duetime_monthly(__alarm_info_t *__alarm_info);
 static time_t __alarm_next_duetime_weekly(__alarm_info_t *__alarm_info);
-static bool __find_next_alarm_to_be_scheduled(time_t *min_due_time);
+static void __alarm_schedule_cb(__alarm_info_t *__alarm_info, void *data);
 #ifdef __ALARM_BOOT
 /*alarm boot*/
 static bool __find_next_alarm_to_be_scheduled_power_on(time_t *min_due_time);
@@ -60,10 +60,16 @@ bool _alarm_find_mintime_power_on(time_t *min_time);
 #endif
 bool _alarm_schedule(void);
 
+#define SCHEDULED_ALARM_POOL_SLAB 32
+
+/* the scheduled list is rebuilt every time the timer is re-armed, so its
+   entries are taken from a pool and reused */
+static __alarm_pool_t *scheduled_alarm_pool = NULL;
+
 static void __free_scheduled_alarm(gpointer data, gpointer user_data)
 {
 	if (data != NULL) {
-		g_free(data);
+		_alarm_pool_free(scheduled_alarm_pool, data);
 	}
 }
 
@@ -102,7 +108,13 @@ bool _add_to_scheduled_alarm_list(__alarm_info_t *__alarm_info)
 	__scheduled_alarm_t *alarm = NULL;
 	__scheduled_alarm_t *entry = NULL;
 
-	alarm = g_malloc(sizeof(__scheduled_alarm_t));
+	if (scheduled_alarm_pool == NULL) {
+		scheduled_alarm_pool = _alarm_pool_new("scheduled_alarm",
+						sizeof(__scheduled_alarm_t),
+						SCHEDULED_ALARM_POOL_SLAB);
+	}
+
+	alarm = _alarm_pool_alloc0(scheduled_alarm_pool);
 	if (alarm == NULL) {
 		return false;
 	}
@@ -165,8 +177,8 @@ bool _remove_from_scheduled_alarm_list(int pid, alarm_id_t alarm_id)
 		alarm = iter->data;
 		if (alarm->alarm_id == alarm_id) {
 			g_scheduled_alarm_list =
-			    g_slist_remove(g_scheduled_alarm_list, iter->data);
-			/*g_free(iter->data); */
+			    g_slist_remove(g_scheduled_alarm_list, alarm);
+			__free_scheduled_alarm(alarm, NULL);
 			result = true;
 			break;
 		}
@@ -214,10 +226,20 @@ static time_t __alarm_next_duetime_once(__alarm_info_t *__alarm_info)
 
 }
 
+/*
+ * The result is the one of the former loop, which added the interval until
+ * the due time passed, except in two intended cases :
+ * - tm_isdst is set to -1. It was left uninitialized, so mktime() could
+ *   shift the start time by an hour.
+ * - a non-positive interval is logged and the start time is returned. The
+ *   loop did not terminate.
+ */
 static time_t __alarm_next_duetime_repeat(__alarm_info_t *__alarm_info)
 {
 	time_t due_time = 0;
 	time_t current_time = 0;
+	time_t threshold = 0;
+	time_t interval = 0;
 	struct tm duetime_tm;
 
 	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
@@ -233,13 +255,26 @@ static time_t __alarm_next_duetime_repeat(__alarm_info_t *__alarm_info)
 	duetime_tm.tm_year = start->year - 1900;
 	duetime_tm.tm_mon = start->month - 1;
 	duetime_tm.tm_mday = start->day;
+	duetime_tm.tm_isdst = -1;
 
 	due_time = mktime(&duetime_tm);
 
-	while (__alarm_info->start > due_time || current_time >= due_time) {
-		due_time += alarm_info->mode.u_interval.interval;
-
-		/* due_time = mktime(&duetime_tm); */
+	/* the next expiry is the first due_time + k * interval which is after
+	   current_time and not before the start time. It is computed at once,
+	   so a stale start time does not cost anything. */
+	threshold = current_time + 1;
+	if (__alarm_info->start > threshold)
+		threshold = __alarm_info->start;
+
+	interval = alarm_info->mode.u_interval.interval;
+	if (due_time < threshold) {
+		if (interval <= 0) {
+			ALARM_MGR_EXCEPTION_PRINT("interval(%ld) is wrong\n",
+						  (long)interval);
+		} else {
+			due_time += (threshold - due_time + interval - 1)
+			    / interval * interval;
+		}
 	}
 	localtime_r(&due_time, &duetime_tm);
 
@@ -254,11 +289,21 @@ static time_t __alarm_next_duetime_repeat(__alarm_info_t *__alarm_info)
 
 }
 
+/*
+ * The former loop called mktime() for every year from the start year on.
+ * It drifted as the monthly loop below does : February 29 to 31 is moved
+ * into March, and tm_isdst, which is taken from the current time, moves the
+ * time of day in the years with the other DST state, by 30 minutes in zones
+ * such as Australia/Lord_Howe. The result differs from the loop only where
+ * the loop drifted.
+ */
 static time_t __alarm_next_duetime_annually(__alarm_info_t *__alarm_info)
 {
 	time_t due_time = 0;
 	time_t current_time = 0;
+	time_t threshold = 0;
 	struct tm duetime_tm;
+	struct tm threshold_tm;
 	int wday;
 
 	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
@@ -280,6 +325,18 @@ static time_t __alarm_next_duetime_annually(__alarm_info_t *__alarm_info)
 
 	due_time = mktime(&duetime_tm);
 
+	/* jump to the year before the one of the threshold, so that the loop
+	   below takes two steps at most however old the start year is */
+	threshold = __alarm_info->start > current_time ?
+	    __alarm_info->start : current_time;
+	if (threshold > due_time) {
+		localtime_r(&threshold, &threshold_tm);
+		if (threshold_tm.tm_year - 1 > duetime_tm.tm_year) {
+			duetime_tm.tm_year = threshold_tm.tm_year - 1;
+			due_time = mktime(&duetime_tm);
+		}
+	}
+
 	while (__alarm_info->start > due_time || current_time > due_time) {
 		duetime_tm.tm_year += 1;
 		due_time = mktime(&duetime_tm);
@@ -289,11 +346,24 @@ static time_t __alarm_next_duetime_annually(__alarm_info_t *__alarm_info)
 
 }
 
+/*
+ * The former loop called mktime() for every month from the start month on,
+ * and every call could normalize the date of duetime_tm : a day which does
+ * not exist in a month (29 to 31) is moved into the next month, and an hour
+ * which does not exist because of a DST change is moved, sometimes across
+ * midnight. The loop kept the moved date for the following months, so an
+ * old start month could drift by days. The date is now normalized in the
+ * month jumped to and in the steps after it only, so the result differs
+ * from the loop when the loop drifted; it is closer to the requested day.
+ */
 static time_t __alarm_next_duetime_monthly(__alarm_info_t *__alarm_info)
 {
 	time_t due_time = 0;
 	time_t current_time = 0;
+	time_t threshold = 0;
 	struct tm duetime_tm;
+	struct tm threshold_tm;
+	int months;
 	int wday;
 
 	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
@@ -319,6 +389,22 @@ static time_t __alarm_next_duetime_monthly(__alarm_info_t *__alarm_info)
 
 	due_time = mktime(&duetime_tm);
 
+	/* jump to the month before the one of the threshold, so that the loop
+	   below takes two steps at most however old the start month is */
+	threshold = __alarm_info->start > current_time ?
+	    __alarm_info->start : current_time;
+	if (threshold > due_time) {
+		localtime_r(&threshold, &threshold_tm);
+		months = (threshold_tm.tm_year - duetime_tm.tm_year) * 12
+		    + threshold_tm.tm_mon - duetime_tm.tm_mon - 1;
+		if (months > 0) {
+			months += duetime_tm.tm_mon;
+			duetime_tm.tm_year += months / 12;
+			duetime_tm.tm_mon = months % 12;
+			due_time = mktime(&duetime_tm);
+		}
+	}
+
 	while (__alarm_info->start > due_time || current_time > due_time) {
 		duetime_tm.tm_mon += 1;
 		if (duetime_tm.tm_mon == 12) {
@@ -444,52 +530,6 @@ time_t _alarm_next_duetime(__alarm_info_t *__alarm_info)
 
 }
 
-static bool __find_next_alarm_to_be_scheduled(time_t *min_due_time)
-{
-	time_t current_time;
-	time_t min_time = -1;
-	time_t due_time;
-	GSList *iter = NULL;
-	__alarm_info_t *entry = NULL;
-
-	time(&current_time);
-
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		entry = iter->data;
-		due_time = entry->due_time;
-
-		double interval = 0;
-
-		ALARM_MGR_LOG_PRINT("alarm[%d] with duetime(%u) at "
-				    "current(%u) pid: (%d)\n",
-		     entry->alarm_id, due_time, current_time, entry->pid);
-		if (due_time == 0)	/*0 means this alarm 
-			has been disabled*/ {
-			continue;
-		}
-
-		interval = difftime(due_time, current_time);
-
-		if (interval <= 0)	/*2008.08.06 when the alarm expires, 
-			it may makes an error.*/ {
-			ALARM_MGR_LOG_PRINT("this may be error.. alarm[%d]\n",
-					    entry->alarm_id);
-			continue;
-		}
-
-		interval = difftime(due_time, min_time);
-
-		if ((interval < 0) || min_time == -1) {
-			min_time = due_time;
-		}
-
-	}
-
-	*min_due_time = min_time;
-	return true;
-}
-
 #ifdef __ALARM_BOOT
 /*alarm boot*/
 static bool __find_next_alarm_to_be_scheduled_power_on(time_t *min_due_time)
@@ -500,7 +540,7 @@ static bool __find_next_alarm_to_be_scheduled_power_on(time_t *min_due_time)
 	struct tm duetime_tm;
 	__alarm_info_t *entry = NULL;
 	struct tm *temp_info;
-	GSList *iter = NULL;
+	__alarm_table_iter_t iter;
 
 	time(&current_time);
 
@@ -515,9 +555,8 @@ static bool __find_next_alarm_to_be_scheduled_power_on(time_t *min_due_time)
 		     temp_info->tm_mon, temp_info->tm_mday, temp_info->tm_hour,
 		     temp_info->tm_min);
 
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		entry = iter->data;
+	_alarm_table_iter_init(&iter);
+	while (_alarm_table_iter_next(&iter, &entry)) {
 		due_time = entry->due_time;
 
 		double interval = 0;
@@ -563,40 +602,262 @@ static bool __find_next_alarm_to_be_scheduled_power_on(time_t *min_due_time)
 }
 #endif
 
-bool _alarm_schedule()
+/*
+ * Returns the latest time an alarm may be expired at. An inexact alarm
+ * (ALARM_TYPE_INEXACT) may be delayed by its window, which is carried in
+ * reserved_info, so that it is expired together with other alarms.
+ */
+time_t _alarm_deadline(__alarm_info_t *__alarm_info)
 {
+	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
+	time_t window = alarm_info->reserved_info;
+
+	if (!(alarm_info->alarm_type & ALARM_TYPE_INEXACT) || window <= 0)
+		return __alarm_info->due_time;
+
+	if (window > ALARM_WINDOW_MAX)
+		window = ALARM_WINDOW_MAX;
+
+	return __alarm_info->due_time + window;
+}
+
+typedef struct {
 	time_t current_time;
-	time_t due_time;
 	time_t min_time;
-	GSList *iter;
+} __alarm_batch_t;
+
+static void __alarm_deadline_cb(__alarm_info_t *__alarm_info, void *data)
+{
+	__alarm_batch_t *batch = data;
+	time_t deadline = _alarm_deadline(__alarm_info);
+
+	/* an alarm which has been missed is expired with the batch */
+	if (deadline > batch->current_time && deadline < batch->min_time)
+		batch->min_time = deadline;
+}
+
+static void __alarm_schedule_cb(__alarm_info_t *__alarm_info, void *data)
+{
+	_add_to_scheduled_alarm_list(__alarm_info);
+}
+
+bool _alarm_schedule()
+{
+	time_t current_time;
+	__alarm_batch_t batch;
 	__alarm_info_t *entry = NULL;
 
 	int min = -1;
 
 	time(&current_time);
 
-	min_time = 0;
+	/* the scheduled alarm list is rebuilt from the due-time queue, so that
+	   an alarm cannot be scheduled twice (e.g. after the dummy timer) */
+	_clear_scheduled_alarm_list();
 
-	__find_next_alarm_to_be_scheduled(&min_time);
+	entry = _alarm_queue_first(current_time);
 
-	if (min_time == -1) {
+	if (entry == NULL) {
 		ALARM_MGR_LOG_PRINT("[alarm-server][schedule]: There is no "
 				    "alarm to be scheduled..\n");
 	} else {
-		for (iter = alarm_context.alarms; iter != NULL;
-		     iter = g_slist_next(iter)) {
-			entry = iter->data;
-			due_time = entry->due_time;
+		ALARM_MGR_LOG_PRINT("alarm[%d] with duetime(%u) at "
+				    "current(%u) pid: (%d)\n",
+		     entry->alarm_id, entry->due_time, current_time, entry->pid);
 
-			if (due_time == min_time) {
-				_add_to_scheduled_alarm_list(entry);
-			}
+		/* the timer is armed at the earliest deadline, and every alarm
+		   due by then is expired with it. An alarm whose deadline is
+		   earlier is due before the first deadline, so one pass finds
+		   the earliest one. */
+		batch.current_time = current_time;
+		batch.min_time = _alarm_deadline(entry);
+		_alarm_queue_foreach_due(batch.min_time, __alarm_deadline_cb,
+					 &batch);
+
+		_alarm_queue_foreach_due(batch.min_time, __alarm_schedule_cb,
+					 NULL);
+
+		_alarm_set_timer(&alarm_context, alarm_context.timer,
+				 batch.min_time, min);
+
+	}
+
+	return true;
+}
+
+/*
+ * lazy boot
+ *
+ * In the lazy boot mode the due time saved in the registry is used as a
+ * hint while the alarms are loaded, instead of being computed for every
+ * alarm before the first timer is armed. Only the alarms which come first
+ * are computed at once, and the rest of them are computed in batches from
+ * idle callbacks, so that requests can be served right after startup.
+ * Alarms whose saved due time has already passed are not scheduled until
+ * their due time is computed.
+ */
+#define ALARM_BOOT_EAGER_COUNT 16
+#define ALARM_BOOT_BATCH_SIZE 256
+
+typedef struct {
+	bool lazy;
+	GHashTable *pending;	/* ids of alarms whose due_time is a hint */
+	guint source;
+	void (*rescheduled)(void);	/* called when the timer is re-armed */
+} __alarm_boot_t;
 
+static __alarm_boot_t alarm_boot_ctx = { false, NULL, 0, NULL };
+
+/*
+ * This function must be called before the alarms are loaded from the
+ * registry. NULL or an unknown mode selects the eager mode.
+ */
+bool _alarm_boot_init(const char *mode, void (*rescheduled)(void))
+{
+	alarm_boot_ctx.lazy = mode != NULL && strcmp(mode, "lazy") == 0;
+	alarm_boot_ctx.rescheduled = rescheduled;
+
+	if (mode != NULL && !alarm_boot_ctx.lazy
+	    && strcmp(mode, "eager") != 0) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:unknown boot "
+					  "mode(%s), eager is used\n", mode);
+	}
+
+	if (alarm_boot_ctx.source > 0) {
+		g_source_remove(alarm_boot_ctx.source);
+		alarm_boot_ctx.source = 0;
+	}
+
+	if (alarm_boot_ctx.pending == NULL) {
+		alarm_boot_ctx.pending = g_hash_table_new(g_direct_hash,
+							  g_direct_equal);
+	} else {
+		g_hash_table_remove_all(alarm_boot_ctx.pending);
 	}
 
-		_alarm_set_timer(&alarm_context, alarm_context.timer, min_time,
-				 min);
+	ALARM_MGR_LOG_PRINT("[alarm-server]:boot mode is %s\n",
+			    alarm_boot_ctx.lazy ? "lazy" : "eager");
+
+	return alarm_boot_ctx.pending != NULL;
+}
+
+/* sets due_time of an alarm loaded from the registry */
+void _alarm_boot_duetime(__alarm_info_t *__alarm_info, time_t saved_due_time)
+{
+	time_t current_time;
+
+	if (!alarm_boot_ctx.lazy) {
+		_alarm_next_duetime(__alarm_info);
+		return;
+	}
+
+	time(&current_time);
+
+	__alarm_info->due_time =
+	    saved_due_time > current_time ? saved_due_time : 0;
+	g_hash_table_insert(alarm_boot_ctx.pending,
+			    GINT_TO_POINTER(__alarm_info->alarm_id),
+			    GINT_TO_POINTER(__alarm_info->alarm_id));
+}
+
+static bool __alarm_boot_is_pending(__alarm_info_t *__alarm_info)
+{
+	return g_hash_table_lookup(alarm_boot_ctx.pending,
+			GINT_TO_POINTER(__alarm_info->alarm_id)) != NULL;
+}
+
+static gboolean __alarm_boot_idle_cb(gpointer user_data)
+{
+	GHashTableIter iter;
+	gpointer key = NULL;
+	__alarm_info_t *entry = NULL;
+	time_t current_time;
+	time_t old_due_time;
+	bool reschedule = false;
+	int count = 0;
+
+	time(&current_time);
+
+	g_hash_table_iter_init(&iter, alarm_boot_ctx.pending);
+	while (count < ALARM_BOOT_BATCH_SIZE
+	       && g_hash_table_iter_next(&iter, &key, NULL)) {
+		g_hash_table_iter_remove(&iter);
+		count++;
+
+		/* it may have been removed or updated in the meantime */
+		entry = _alarm_table_find(GPOINTER_TO_INT(key));
+		if (entry == NULL)
+			continue;
+
+		old_due_time = entry->due_time;
+		_alarm_next_duetime(entry);
+		_alarm_queue_update(entry);
+
+		if (entry->due_time == old_due_time)
+			continue;
+
+		/* the alarm leaves or joins the head of the queue */
+		if (alarm_context.c_due_time < current_time
+		    || (old_due_time != 0
+			&& old_due_time <= alarm_context.c_due_time)
+		    || (entry->due_time > current_time
+			&& entry->due_time <= alarm_context.c_due_time))
+			reschedule = true;
+	}
+
+	if (reschedule) {
+		_alarm_schedule();
+		if (alarm_boot_ctx.rescheduled)
+			alarm_boot_ctx.rescheduled();
+	}
+
+	if (g_hash_table_size(alarm_boot_ctx.pending) > 0)
+		return TRUE;
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:due time of every alarm is "
+			    "computed\n");
+	alarm_boot_ctx.source = 0;
+
+	return FALSE;
+}
+
+/*
+ * Schedules the alarms loaded from the registry. In the lazy mode, the
+ * alarms at the head of the due-time queue are computed until the head is
+ * exact, and the rest of them are left to the idle callbacks.
+ */
+bool _alarm_boot_schedule()
+{
+	__alarm_info_t *entry = NULL;
+	time_t current_time;
+	int i;
+
+	if (!alarm_boot_ctx.lazy)
+		return _alarm_schedule();
+
+	time(&current_time);
+
+	for (i = 0; i < ALARM_BOOT_EAGER_COUNT; i++) {
+		entry = _alarm_queue_first(current_time);
+		if (entry == NULL || !__alarm_boot_is_pending(entry))
+			break;
+
+		g_hash_table_remove(alarm_boot_ctx.pending,
+				    GINT_TO_POINTER(entry->alarm_id));
+		_alarm_next_duetime(entry);
+		_alarm_queue_update(entry);
+	}
+
+	_alarm_schedule();
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:%d alarms are computed at boot, "
+			    "%d alarms are left to idle time\n", i,
+			    g_hash_table_size(alarm_boot_ctx.pending));
 
+	if (g_hash_table_size(alarm_boot_ctx.pending) > 0
+	    && alarm_boot_ctx.source == 0) {
+		alarm_boot_ctx.source =
+		    g_idle_add(__alarm_boot_idle_cb, NULL);
 	}
 
 	return true;
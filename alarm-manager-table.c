@@ -0,0 +1,317 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<time.h>
+#include<string.h>
+#include<sys/types.h>
+
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+extern __alarm_server_context_t alarm_context;
+
+/*
+ * The alarm table owns every __alarm_info_t registered in the server.
+ * Alarms are indexed by alarm_id, so that create/update/delete/get requests
+ * do not have to walk all the registered alarms. They are also listed per
+ * application (quark_app_unique_name) in the order of alarm_id (signed), so
+ * that the alarms of an application are counted and enumerated page by page
+ * without walking the alarms of the others. New ids are mostly the greatest
+ * ones, and the registry is loaded in the order of alarm_id, so an alarm is
+ * usually appended to the list of its application.
+ * The due-time queue is kept in step with the table : alarms are queued when
+ * they are added and dequeued before they are freed.
+ */
+
+#define ALARM_INFO_POOL_SLAB 64
+
+static __alarm_pool_t *alarm_info_pool = NULL;
+
+/*
+ * Alarm records are allocated from a fixed-size pool (alarm-manager-pool.c),
+ * which reuses the records freed before instead of calling malloc for each
+ * record. The record returned is zero-filled and not queued, or NULL when
+ * the memory is exhausted.
+ */
+__alarm_info_t *_alarm_info_new()
+{
+	__alarm_info_t *__alarm_info = NULL;
+
+	if (alarm_info_pool == NULL) {
+		alarm_info_pool = _alarm_pool_new("alarm_info",
+						  sizeof(__alarm_info_t),
+						  ALARM_INFO_POOL_SLAB);
+	}
+
+	__alarm_info = _alarm_pool_alloc0(alarm_info_pool);
+	if (__alarm_info == NULL)
+		return NULL;
+
+	__alarm_info->queue_idx = -1;
+	__alarm_info->queue_link = NULL;
+	__alarm_info->app_link = NULL;
+	__alarm_info->bundle = NULL;
+
+	return __alarm_info;
+}
+
+void _alarm_info_free(__alarm_info_t *__alarm_info)
+{
+	if (__alarm_info != NULL) {
+		_alarm_bundle_unref(__alarm_info->bundle);
+		_alarm_pool_free(alarm_info_pool, __alarm_info);
+	}
+}
+
+static void __alarm_table_app_add(__alarm_info_t *__alarm_info)
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+	GQueue *alarms = NULL;
+	GList *sibling = NULL;
+	__alarm_info_t *entry = NULL;
+
+	alarms = g_hash_table_lookup(table->by_app,
+			GUINT_TO_POINTER(__alarm_info->quark_app_unique_name));
+	if (alarms == NULL) {
+		alarms = g_queue_new();
+		g_hash_table_insert(table->by_app,
+			GUINT_TO_POINTER(__alarm_info->quark_app_unique_name),
+			alarms);
+	}
+
+	for (sibling = g_queue_peek_tail_link(alarms); sibling != NULL;
+	     sibling = sibling->prev) {
+		entry = sibling->data;
+		if (entry->alarm_id < __alarm_info->alarm_id)
+			break;
+	}
+
+	if (sibling == NULL) {
+		g_queue_push_head(alarms, __alarm_info);
+		__alarm_info->app_link = g_queue_peek_head_link(alarms);
+	} else {
+		g_queue_insert_after(alarms, sibling, __alarm_info);
+		__alarm_info->app_link = sibling->next;
+	}
+}
+
+static void __alarm_table_app_remove(__alarm_info_t *__alarm_info)
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+	GQueue *alarms = NULL;
+
+	if (__alarm_info->app_link == NULL)
+		return;
+
+	alarms = g_hash_table_lookup(table->by_app,
+			GUINT_TO_POINTER(__alarm_info->quark_app_unique_name));
+	if (alarms != NULL) {
+		g_queue_delete_link(alarms, __alarm_info->app_link);
+		if (g_queue_is_empty(alarms)) {
+			g_hash_table_remove(table->by_app,
+			GUINT_TO_POINTER(__alarm_info->quark_app_unique_name));
+		}
+	}
+
+	__alarm_info->app_link = NULL;
+}
+
+static void __alarm_table_free_entry(gpointer data)
+{
+	if (data != NULL) {
+		_alarm_queue_remove((__alarm_info_t *)data);
+		__alarm_table_app_remove((__alarm_info_t *)data);
+		_alarm_info_free((__alarm_info_t *)data);
+	}
+}
+
+static void __alarm_table_free_app(gpointer data)
+{
+	g_queue_free((GQueue *)data);
+}
+
+bool _alarm_table_init()
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+
+	if (table->by_id != NULL) {
+		_alarm_queue_clear();
+		g_hash_table_remove_all(table->by_id);
+		return true;
+	}
+
+	table->by_app = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+					      NULL, __alarm_table_free_app);
+	table->by_id = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+					     NULL, __alarm_table_free_entry);
+	if (table->by_id == NULL || table->by_app == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:alarm table "
+					  "creation failed\n");
+		return false;
+	}
+
+	return true;
+}
+
+void _alarm_table_clear()
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+
+	if (table->by_id != NULL) {
+		_alarm_queue_clear();
+		g_hash_table_remove_all(table->by_id);
+	}
+}
+
+static bool __alarm_table_insert(__alarm_info_t *__alarm_info, bool queue)
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+
+	if (__alarm_info == NULL
+	    || g_hash_table_lookup(table->by_id,
+			GINT_TO_POINTER(__alarm_info->alarm_id)) != NULL) {
+		return false;
+	}
+
+	if (queue && !_alarm_queue_update(__alarm_info))
+		return false;
+
+	g_hash_table_insert(table->by_id,
+			    GINT_TO_POINTER(__alarm_info->alarm_id),
+			    __alarm_info);
+	__alarm_table_app_add(__alarm_info);
+
+	return true;
+}
+
+bool _alarm_table_add(__alarm_info_t *__alarm_info)
+{
+	return __alarm_table_insert(__alarm_info, true);
+}
+
+/*
+ * Adds an alarm without queueing it. It is used to load many alarms at
+ * once, and the caller must call _alarm_queue_rebuild() after the last one.
+ */
+bool _alarm_table_load(__alarm_info_t *__alarm_info)
+{
+	return __alarm_table_insert(__alarm_info, false);
+}
+
+__alarm_info_t *_alarm_table_find(alarm_id_t alarm_id)
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+
+	return g_hash_table_lookup(table->by_id, GINT_TO_POINTER(alarm_id));
+}
+
+bool _alarm_table_remove(alarm_id_t alarm_id)
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+
+	/* the entry is freed by the table */
+	return g_hash_table_remove(table->by_id, GINT_TO_POINTER(alarm_id));
+}
+
+guint _alarm_table_size()
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+
+	return g_hash_table_size(table->by_id);
+}
+
+guint _alarm_table_app_size(GQuark quark_app_unique_name)
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+	GQueue *alarms = NULL;
+
+	alarms = g_hash_table_lookup(table->by_app,
+				     GUINT_TO_POINTER(quark_app_unique_name));
+
+	return alarms ? g_queue_get_length(alarms) : 0;
+}
+
+/*
+ * Returns the alarms of an application as a list of __alarm_info_t ordered
+ * by alarm_id, which is owned by the table and must not be modified.
+ */
+GList *_alarm_table_app_alarms(GQuark quark_app_unique_name)
+{
+	__alarm_table_t *table = &alarm_context.alarms;
+	GQueue *alarms = NULL;
+
+	alarms = g_hash_table_lookup(table->by_app,
+				     GUINT_TO_POINTER(quark_app_unique_name));
+
+	return alarms ? g_queue_peek_head_link(alarms) : NULL;
+}
+
+void _alarm_table_iter_init(__alarm_table_iter_t *iter)
+{
+	g_hash_table_iter_init(&iter->iter, alarm_context.alarms.by_id);
+}
+
+bool _alarm_table_iter_next(__alarm_table_iter_t *iter,
+			    __alarm_info_t **__alarm_info)
+{
+	gpointer value = NULL;
+
+	if (!g_hash_table_iter_next(&iter->iter, NULL, &value)) {
+		return false;
+	}
+
+	*__alarm_info = value;
+	return true;
+}
+
+/*
+ * Returns the part of _alarm_table_app_alarms() whose ids are greater than
+ * after_id. It is found from the alarm after_id in O(1) while that alarm is
+ * registered, and by walking the alarms of the application otherwise.
+ */
+GList *_alarm_table_app_alarms_after(GQuark quark_app_unique_name,
+				     alarm_id_t after_id)
+{
+	__alarm_info_t *entry = NULL;
+	GList *iter = NULL;
+
+	entry = _alarm_table_find(after_id);
+	if (entry != NULL && entry->app_link != NULL
+	    && entry->quark_app_unique_name == quark_app_unique_name)
+		return g_list_next(entry->app_link);
+
+	for (iter = _alarm_table_app_alarms(quark_app_unique_name);
+	     iter != NULL; iter = g_list_next(iter)) {
+		entry = iter->data;
+		if (entry->alarm_id > after_id)
+			break;
+	}
+
+	return iter;
+}
@@ -0,0 +1,549 @@
+/*
+ *  alarm-manager
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Venkatesha Sarpangala <sarpangala.v@samsung.com>, Jayoun Lee <airjany@samsung.com>,
+ * Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<time.h>
+#include<string.h>
+#include<sys/types.h>
+
+#include<glib.h>
+
+#include"alarm.h"
+#include"alarm-internal.h"
+
+/*
+ * hierarchical timing wheel backend of the due-time queue.
+ *
+ * The root wheel has one slot per second for the next 256 seconds. Each
+ * coarser level has 64 slots, and a slot covers a whole turn of the level
+ * below it :
+ *   level 1 : 256 sec per slot, up to ~4.5 hours
+ *   level 2 : 16384 sec per slot, up to ~12 days
+ *   level 3 : 1048576 sec per slot, up to ~2 years
+ * Alarms further than that are kept in the overflow slot.
+ *
+ * Slots are indexed by the absolute due_time, so that an alarm is moved
+ * ("cascaded") to a finer level only when the wheel base enters its slot.
+ * Queueing, repositioning and removing an alarm are O(1).
+ *
+ * Every slot caches its earliest alarm. The cache is kept up to date when an
+ * alarm is queued, and it is dropped when the earliest alarm leaves the
+ * slot; the slot is scanned again the next time its earliest alarm is
+ * needed. The alarms of each level are counted, so that the empty levels
+ * are skipped when the wheel is turned or searched.
+ */
+
+#define WHEEL_ROOT_BITS 8
+#define WHEEL_LVL_BITS 6
+#define WHEEL_LEVELS 4
+
+#define WHEEL_ROOT_SIZE (1 << WHEEL_ROOT_BITS)
+#define WHEEL_LVL_SIZE (1 << WHEEL_LVL_BITS)
+#define WHEEL_ROOT_MASK (WHEEL_ROOT_SIZE - 1)
+#define WHEEL_LVL_MASK (WHEEL_LVL_SIZE - 1)
+
+/* granularity of the coarser levels (lvl >= 1) in bits */
+#define WHEEL_SHIFT(lvl) (WHEEL_ROOT_BITS + ((lvl) - 1) * WHEEL_LVL_BITS)
+/* alarms due within WHEEL_RANGE(lvl) seconds from the base fit in lvl */
+#define WHEEL_RANGE(lvl) (1UL << (WHEEL_SHIFT(lvl) + WHEEL_LVL_BITS))
+#define WHEEL_LVL_SLOT(lvl, idx) \
+	(WHEEL_ROOT_SIZE + ((lvl) - 1) * WHEEL_LVL_SIZE + (idx))
+
+#define WHEEL_NR_SLOTS (WHEEL_ROOT_SIZE + (WHEEL_LEVELS - 1) * WHEEL_LVL_SIZE)
+#define WHEEL_OVERFLOW_SLOT WHEEL_NR_SLOTS	/* beyond the last level */
+#define WHEEL_PASSED_SLOT (WHEEL_NR_SLOTS + 1)	/* due before the base */
+
+/* when the base has to move further than this, the wheel is refilled
+   instead of being turned */
+#define WHEEL_MAX_ADVANCE WHEEL_RANGE(2)
+
+typedef struct {
+	GQueue slots[WHEEL_NR_SLOTS + 2];
+	/* the earliest alarm of each slot, NULL if it is not known */
+	__alarm_info_t *min[WHEEL_NR_SLOTS + 2];
+	guint count[WHEEL_LEVELS];	/* alarms queued in each level */
+	time_t base;		/* the root wheel starts at this time */
+} __alarm_wheel_t;
+
+static __alarm_wheel_t alarm_wheel;
+
+/* returns the level of the slot, or -1 for the overflow and passed slots */
+static int __wheel_level_of(int slot)
+{
+	if (slot < WHEEL_ROOT_SIZE)
+		return 0;
+	if (slot < WHEEL_NR_SLOTS)
+		return 1 + (slot - WHEEL_ROOT_SIZE) / WHEEL_LVL_SIZE;
+	return -1;
+}
+
+static int __wheel_slot_of(time_t due_time)
+{
+	unsigned long expires = (unsigned long)due_time;
+	unsigned long delta;
+	int lvl;
+
+	if (due_time < alarm_wheel.base)
+		return WHEEL_PASSED_SLOT;
+
+	delta = (unsigned long)(due_time - alarm_wheel.base);
+	if (delta < WHEEL_ROOT_SIZE)
+		return expires & WHEEL_ROOT_MASK;
+
+	for (lvl = 1; lvl < WHEEL_LEVELS; lvl++) {
+		if (delta < WHEEL_RANGE(lvl))
+			return WHEEL_LVL_SLOT(lvl,
+				(expires >> WHEEL_SHIFT(lvl)) & WHEEL_LVL_MASK);
+	}
+
+	return WHEEL_OVERFLOW_SLOT;
+}
+
+static bool __wheel_contains(__alarm_info_t *entry)
+{
+	return entry->queue_idx >= 0 && entry->queue_link != NULL
+	    && entry->queue_link->data == entry;
+}
+
+static void __wheel_push(int slot, __alarm_info_t *entry, GList *link)
+{
+	__alarm_info_t *min = alarm_wheel.min[slot];
+	int lvl = __wheel_level_of(slot);
+
+	if (lvl >= 0)
+		alarm_wheel.count[lvl]++;
+
+	if (g_queue_is_empty(&alarm_wheel.slots[slot]))
+		alarm_wheel.min[slot] = entry;
+	else if (min != NULL && entry->due_time < min->due_time)
+		alarm_wheel.min[slot] = entry;
+
+	link->data = entry;
+	g_queue_push_tail_link(&alarm_wheel.slots[slot], link);
+
+	entry->queue_idx = slot;
+	entry->queue_link = link;
+}
+
+/* empties the slot, and returns its alarms */
+static GQueue __wheel_take_slot(int slot)
+{
+	GQueue pending = alarm_wheel.slots[slot];
+	int lvl = __wheel_level_of(slot);
+
+	if (lvl >= 0)
+		alarm_wheel.count[lvl] -= pending.length;
+
+	g_queue_init(&alarm_wheel.slots[slot]);
+	alarm_wheel.min[slot] = NULL;
+
+	return pending;
+}
+
+static void __wheel_insert(__alarm_info_t *entry, GList *link)
+{
+	__wheel_push(__wheel_slot_of(entry->due_time), entry, link);
+}
+
+static GList *__wheel_unlink(__alarm_info_t *entry)
+{
+	GList *link = entry->queue_link;
+	int lvl = __wheel_level_of(entry->queue_idx);
+
+	if (lvl >= 0)
+		alarm_wheel.count[lvl]--;
+
+	g_queue_unlink(&alarm_wheel.slots[entry->queue_idx], link);
+	if (alarm_wheel.min[entry->queue_idx] == entry)
+		alarm_wheel.min[entry->queue_idx] = NULL;
+
+	entry->queue_idx = -1;
+	entry->queue_link = NULL;
+
+	return link;
+}
+
+/* drops every alarm of the slot from the queue */
+static void __wheel_drop_slot(int slot)
+{
+	GList *link = NULL;
+	__alarm_info_t *entry = NULL;
+
+	GQueue pending = __wheel_take_slot(slot);
+
+	while ((link = g_queue_pop_head_link(&pending)) != NULL) {
+		entry = link->data;
+		entry->queue_idx = -1;
+		entry->queue_link = NULL;
+		g_list_free_1(link);
+	}
+}
+
+/*
+ * The alarms of the slot are due by current_time. They are dropped from the
+ * queue, except the inexact alarms whose window is not over yet, which are
+ * kept in the passed slot.
+ */
+static void __wheel_expire_slot(int slot, time_t current_time)
+{
+	GQueue pending = __wheel_take_slot(slot);
+	GList *link = NULL;
+	__alarm_info_t *entry = NULL;
+
+	while ((link = g_queue_pop_head_link(&pending)) != NULL) {
+		entry = link->data;
+		if (_alarm_deadline(entry) > current_time) {
+			__wheel_push(WHEEL_PASSED_SLOT, entry, link);
+			continue;
+		}
+
+		ALARM_MGR_LOG_PRINT("this may be error.. alarm[%d]\n",
+				    entry->alarm_id);
+
+		entry->queue_idx = -1;
+		entry->queue_link = NULL;
+		g_list_free_1(link);
+	}
+}
+
+/* requeues every alarm of the slot relative to the current base */
+static void __wheel_cascade(int slot)
+{
+	GQueue pending = __wheel_take_slot(slot);
+	GList *link = NULL;
+
+	while ((link = g_queue_pop_head_link(&pending)) != NULL) {
+		__wheel_insert(link->data, link);
+	}
+}
+
+/* the base has just entered a new turn of the root wheel */
+static void __wheel_cascade_levels()
+{
+	unsigned long base = (unsigned long)alarm_wheel.base;
+	int lvl;
+	int idx;
+
+	for (lvl = 1; lvl < WHEEL_LEVELS; lvl++) {
+		idx = (base >> WHEEL_SHIFT(lvl)) & WHEEL_LVL_MASK;
+		__wheel_cascade(WHEEL_LVL_SLOT(lvl, idx));
+		if (idx != 0)
+			return;
+	}
+
+	__wheel_cascade(WHEEL_OVERFLOW_SLOT);
+}
+
+static void __wheel_clear()
+{
+	int slot;
+
+	for (slot = 0; slot < WHEEL_NR_SLOTS + 2; slot++) {
+		__wheel_drop_slot(slot);
+	}
+}
+
+/* requeues all the queued alarms relative to a new base */
+static void __wheel_refill(time_t base)
+{
+	GQueue pending = G_QUEUE_INIT;
+	GList *link = NULL;
+	int slot;
+
+	for (slot = 0; slot < WHEEL_NR_SLOTS + 2; slot++) {
+		GQueue taken = __wheel_take_slot(slot);
+
+		while ((link = g_queue_pop_head_link(&taken)) != NULL) {
+			g_queue_push_tail_link(&pending, link);
+		}
+	}
+
+	alarm_wheel.base = base;
+
+	while ((link = g_queue_pop_head_link(&pending)) != NULL) {
+		__wheel_insert(link->data, link);
+	}
+}
+
+/*
+ * Returns the next time at which the base has to stop : the end of the turn
+ * of the root wheel while it or level 1 holds alarms, otherwise the next
+ * cascade of the first level which holds alarms.
+ */
+static time_t __wheel_next_stop(time_t base)
+{
+	unsigned long start = (unsigned long)base;
+	int lvl = 1;
+
+	if (alarm_wheel.count[0] == 0) {
+		while (lvl < WHEEL_LEVELS && alarm_wheel.count[lvl] == 0)
+			lvl++;
+	}
+
+	return (time_t)(((start >> WHEEL_SHIFT(lvl)) + 1) << WHEEL_SHIFT(lvl));
+}
+
+/* turns the wheel until the base reaches target, expiring passed alarms */
+static void __wheel_advance(time_t target)
+{
+	time_t base;
+	time_t next;
+	time_t t;
+
+	if (target < alarm_wheel.base
+	    || (unsigned long)(target - alarm_wheel.base) >= WHEEL_MAX_ADVANCE) {
+		__wheel_refill(target);
+		__wheel_expire_slot(WHEEL_PASSED_SLOT, target - 1);
+		return;
+	}
+
+	while (alarm_wheel.base < target) {
+		base = alarm_wheel.base;
+		next = __wheel_next_stop(base);
+		if (next > target)
+			next = target;
+
+		for (t = base; t < next && alarm_wheel.count[0] > 0; t++) {
+			__wheel_expire_slot(t & WHEEL_ROOT_MASK, target - 1);
+		}
+
+		alarm_wheel.base = next;
+		if ((next & WHEEL_ROOT_MASK) == 0)
+			__wheel_cascade_levels();
+	}
+}
+
+/*
+ * Returns the first non empty slot of a level in due_time order. All alarms
+ * of a root slot have the same due_time, and alarms of a coarser slot are
+ * earlier than the alarms of the following slots of the same level.
+ */
+static int __wheel_first_slot(int lvl)
+{
+	unsigned long base = (unsigned long)alarm_wheel.base;
+	int slot;
+	int i;
+
+	if (alarm_wheel.count[lvl] == 0)
+		return -1;
+
+	if (lvl == 0) {
+		for (i = 0; i < WHEEL_ROOT_SIZE; i++) {
+			slot = (base + i) & WHEEL_ROOT_MASK;
+			if (!g_queue_is_empty(&alarm_wheel.slots[slot]))
+				return slot;
+		}
+		return -1;
+	}
+
+	for (i = 1; i <= WHEEL_LVL_SIZE; i++) {
+		slot = WHEEL_LVL_SLOT(lvl,
+			((base >> WHEEL_SHIFT(lvl)) + i) & WHEEL_LVL_MASK);
+		if (!g_queue_is_empty(&alarm_wheel.slots[slot]))
+			return slot;
+	}
+
+	return -1;
+}
+
+/* returns the earlier of min and the earliest alarm of the slot */
+static __alarm_info_t *__wheel_min_of_slot(int slot, __alarm_info_t *min)
+{
+	GList *link = NULL;
+	__alarm_info_t *entry = NULL;
+	__alarm_info_t *slot_min = alarm_wheel.min[slot];
+
+	if (slot_min == NULL) {
+		for (link = g_queue_peek_head_link(&alarm_wheel.slots[slot]);
+		     link != NULL; link = g_list_next(link)) {
+			entry = link->data;
+			if (slot_min == NULL
+			    || entry->due_time < slot_min->due_time)
+				slot_min = entry;
+		}
+		alarm_wheel.min[slot] = slot_min;
+	}
+
+	if (slot_min != NULL
+	    && (min == NULL || slot_min->due_time < min->due_time))
+		min = slot_min;
+
+	return min;
+}
+
+static bool __wheel_init()
+{
+	int slot;
+
+	for (slot = 0; slot < WHEEL_NR_SLOTS + 2; slot++) {
+		g_queue_init(&alarm_wheel.slots[slot]);
+		alarm_wheel.min[slot] = NULL;
+	}
+	memset(alarm_wheel.count, 0, sizeof(alarm_wheel.count));
+	time(&alarm_wheel.base);
+
+	return true;
+}
+
+static void __wheel_remove(__alarm_info_t *__alarm_info)
+{
+	if (!__wheel_contains(__alarm_info))
+		return;
+
+	g_list_free_1(__wheel_unlink(__alarm_info));
+}
+
+static bool __wheel_update(__alarm_info_t *__alarm_info)
+{
+	GList *link = NULL;
+
+	if (__alarm_info->due_time == 0) {
+		__wheel_remove(__alarm_info);
+		return true;
+	}
+
+	if (__wheel_contains(__alarm_info))
+		link = __wheel_unlink(__alarm_info);
+	else
+		link = g_list_alloc();
+
+	if (link == NULL) {
+		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:timing wheel "
+					  "alloc failed\n");
+		return false;
+	}
+
+	__wheel_insert(__alarm_info, link);
+
+	return true;
+}
+
+/*
+ * A level may hold alarms which are later than the first alarms of the next
+ * level (they have not been cascaded yet), so the first slot of every level
+ * is examined, with the passed and overflow slots. The earliest alarms of
+ * these slots are cached, so the cost is the search of the first non empty
+ * slot of the levels which hold alarms (up to 256 slots for the root wheel
+ * and 64 for the others) as long as the caches hold. A slot whose earliest
+ * alarm has been removed, updated or expired is scanned once, in O(alarms
+ * of the slot). The heap backend returns its first alarm in O(1).
+ */
+static __alarm_info_t *__wheel_first(time_t current_time)
+{
+	__alarm_info_t *min = NULL;
+	int lvl;
+	int slot;
+
+	__wheel_expire_slot(WHEEL_PASSED_SLOT, current_time);
+	__wheel_advance(current_time + 1);
+
+	min = __wheel_min_of_slot(WHEEL_PASSED_SLOT, min);
+	for (lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		slot = __wheel_first_slot(lvl);
+		if (slot >= 0)
+			min = __wheel_min_of_slot(slot, min);
+	}
+
+	return __wheel_min_of_slot(WHEEL_OVERFLOW_SLOT, min);
+}
+
+static void __wheel_foreach_slot(int slot, time_t due_time,
+				 __alarm_queue_cb_t func, void *data)
+{
+	GList *link = NULL;
+	__alarm_info_t *entry = NULL;
+
+	for (link = g_queue_peek_head_link(&alarm_wheel.slots[slot]);
+	     link != NULL; link = g_list_next(link)) {
+		entry = link->data;
+		if (entry->due_time <= due_time)
+			func(entry, data);
+	}
+}
+
+/*
+ * Only the slots which start by due_time are visited : the root slots from
+ * the base to due_time, and the slots of each level in the same order as
+ * __wheel_first_slot().
+ */
+static void __wheel_foreach_due(time_t due_time, __alarm_queue_cb_t func,
+				void *data)
+{
+	unsigned long base = (unsigned long)alarm_wheel.base;
+	unsigned long idx;
+	int lvl;
+	int i;
+
+	__wheel_foreach_slot(WHEEL_PASSED_SLOT, due_time, func, data);
+
+	for (i = 0; i < WHEEL_ROOT_SIZE; i++) {
+		if (alarm_wheel.base + i > due_time)
+			break;
+		__wheel_foreach_slot((base + i) & WHEEL_ROOT_MASK, due_time,
+				     func, data);
+	}
+
+	for (lvl = 1; lvl < WHEEL_LEVELS; lvl++) {
+		for (i = 1; i <= WHEEL_LVL_SIZE; i++) {
+			idx = (base >> WHEEL_SHIFT(lvl)) + i;
+			if ((time_t)(idx << WHEEL_SHIFT(lvl)) > due_time)
+				break;
+			__wheel_foreach_slot(WHEEL_LVL_SLOT(lvl,
+					idx & WHEEL_LVL_MASK), due_time,
+					func, data);
+		}
+	}
+
+	__wheel_foreach_slot(WHEEL_OVERFLOW_SLOT, due_time, func, data);
+}
+
+static bool __wheel_rebuild()
+{
+	__alarm_table_iter_t iter;
+	__alarm_info_t *entry = NULL;
+
+	__wheel_clear();
+	time(&alarm_wheel.base);
+
+	_alarm_table_iter_init(&iter);
+	while (_alarm_table_iter_next(&iter, &entry)) {
+		if (!__wheel_update(entry))
+			return false;
+	}
+
+	return true;
+}
+
+__alarm_queue_ops_t _alarm_wheel_queue_ops = {
+	.name = "wheel",
+	.init = __wheel_init,
+	.clear = __wheel_clear,
+	.update = __wheel_update,
+	.remove = __wheel_remove,
+	.first = __wheel_first,
+	.foreach_due = __wheel_foreach_due,
+	.rebuild = __wheel_rebuild,
+};
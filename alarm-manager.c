@@ -35,6 +35,7 @@
 #include<dbus/dbus.h>
 #include<dbus/dbus-glib-lowlevel.h>
 #include<glib.h>
+#include<glib-unix.h>
 #if !GLIB_CHECK_VERSION (2, 31, 0)
 #include <glib/gmacros.h>
 #else
@@ -49,7 +50,6 @@
 #include <aul.h>
 #include <bundle.h>
 #include <heynoti.h>
-#include <security-server.h>
 #include <db-util.h>
 #include <vconf.h>
 #include <vconf-keys.h>
@@ -76,6 +76,11 @@ bool g_dummy_timer_is_set = FALSE;
 GSList *g_scheduled_alarm_list = NULL;
 
 GSList *g_expired_alarm_list = NULL;
+G_LOCK_DEFINE_STATIC(expired_alarm_list);
+
+/* while a batch request is served, alarms are created or deleted without
+   being scheduled one by one, and they are scheduled at the end of it */
+static int alarm_batch_depth = 0;
 
 #ifndef RTC_WKALM_BOOT_SET
 #define RTC_WKALM_BOOT_SET _IOW('p', 0x80, struct rtc_wkalrm)
@@ -106,9 +111,11 @@ static const char power_rtc[] = "/dev/rtc0";
 
 static bool __alarm_add_to_list(__alarm_info_t *__alarm_info,
 				alarm_id_t *alarm_id);
-static bool __alarm_update_in_list(int pid, alarm_id_t alarm_id,
-				   __alarm_info_t *__alarm_info,
-				   int *error_code);
+static __alarm_info_t *__alarm_update_in_list(int pid,
+					char *app_service_name,
+					alarm_id_t alarm_id,
+					alarm_info_t *alarm_info,
+					int *error_code);
 static bool __alarm_remove_from_list(int pid, alarm_id_t alarm_id,
 				     int *error_code);
 static bool __alarm_set_start_and_end_time(alarm_info_t *alarm_info,
@@ -128,6 +135,7 @@ static bool __alarm_power_off(int app_id, int *error_code);
 static bool __alarm_check_next_duetime(int app_id, int *error_code);
 static void __alarm_send_noti_to_application(const char *app_service_name,
 					     alarm_id_t alarm_id);
+static void __alarm_deliver(__alarm_delivery_t *delivery);
 static void __alarm_expired();
 static gboolean __alarm_handler_idle();
 static void __alarm_handler(int sigNum, siginfo_t *pSigInfo, void *pUContext);
@@ -158,6 +166,10 @@ static void __rtc_set()
 	struct rtc_wkalrm rtc_wk;
 	struct tm due_tm;
 
+	/* the alarms must be in the registry before the device can be
+	   powered off and woken up by RTC */
+	_registry_flush();
+
 #ifdef _SIMUL			/*if build is simulator, we don't need to set
 				   RTC because RTC does not work in simulator.*/
 	ALARM_MGR_EXCEPTION_PRINT("because it is simulator's mode, "
@@ -299,14 +311,7 @@ int _set_rtc_time(time_t _time)
 
 bool __alarm_clean_list()
 {
-	GSList *iter = NULL;
-
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		free(iter->data);
-	}
-
-	g_slist_free(alarm_context.alarms);
+	_alarm_table_clear();
 	return true;
 }
 
@@ -314,50 +319,23 @@ static bool __alarm_add_to_list(__alarm_info_t *__alarm_info,
 				alarm_id_t *alarm_id)
 {
 
-	bool unique_id = false;
 	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
-	__alarm_info_t *entry = NULL;
-
-	GSList *iter = NULL;
 
-	/* FIXME: alarm id must be unique. */
-	__alarm_info->alarm_id = (int)(void *)__alarm_info;
+	__alarm_info->alarm_id = _alarm_id_alloc();
 	ALARM_MGR_LOG_PRINT("__alarm_info->alarm_id is %d", \
 			    __alarm_info->alarm_id);
 
-	while (unique_id == false) {
-		unique_id = true;
-
-		for (iter = alarm_context.alarms; iter != NULL;
-		     iter = g_slist_next(iter)) {
-			entry = iter->data;
-			if (entry->alarm_id == __alarm_info->alarm_id) {
-				__alarm_info->alarm_id++;
-				unique_id = false;
-			}
-		}
-
-	}
-
-	/* list alarms */
-	ALARM_MGR_LOG_PRINT("[alarm-server]: before add\n");
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		entry = iter->data;
-		/*ALARM_MGR_LOG_PRINT("[alarm-server]: alarm_id(%d)\n", 
-		   entry->alarm_id); */
+	if (__alarm_info->alarm_id < 0) {
+		return false;
 	}
 
-	alarm_context.alarms =
-	    g_slist_append(alarm_context.alarms, __alarm_info);
-	/*list alarms */
-	ALARM_MGR_LOG_PRINT("[alarm-server]: after add\n");
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		entry = iter->data;
-		ALARM_MGR_LOG_PRINT("[alarm-server]: alarm_id(%d)\n",
-				    entry->alarm_id);
+	if (!_alarm_table_add(__alarm_info)) {
+		_alarm_id_free(__alarm_info->alarm_id);
+		return false;
 	}
+	ALARM_MGR_LOG_PRINT("[alarm-server]: alarm_id(%d) is added, "
+			    "%d alarms\n", __alarm_info->alarm_id,
+			    _alarm_table_size());
 
 	if (!(alarm_info->alarm_type & ALARM_TYPE_VOLATILE)) {
 		_save_alarms(__alarm_info);
@@ -368,87 +346,76 @@ static bool __alarm_add_to_list(__alarm_info_t *__alarm_info,
 	return true;
 }
 
-static bool __alarm_update_in_list(int pid, alarm_id_t alarm_id,
-				   __alarm_info_t *__alarm_info,
-				   int *error_code)
+/*
+ * Updates the registered alarm in place. Only the fields carried by an
+ * update request and the schedule derived from them are changed; the
+ * destination, the bundle and the links of the alarm are kept. due_time is
+ * recomputed, and the alarm is repositioned in the due-time queue.
+ * Returns the updated alarm, or NULL if alarm_id is not registered.
+ */
+static __alarm_info_t *__alarm_update_in_list(int pid,
+					char *app_service_name,
+					alarm_id_t alarm_id,
+					alarm_info_t *alarm_info,
+					int *error_code)
 {
-	bool found = false;
-	alarm_info_t *alarm_info = &__alarm_info->alarm_info;
-	GSList *iter = NULL;
 	__alarm_info_t *entry = NULL;
 
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		entry = iter->data;
-		if (entry->alarm_id == alarm_id) {
-
-			found = true;
-			__alarm_info->quark_app_unique_name =
-			    entry->quark_app_unique_name;
-			__alarm_info->quark_dst_service_name =
-			    entry->quark_dst_service_name;
-			memcpy(entry, __alarm_info, sizeof(__alarm_info_t));
-
-			break;
-		}
-	}
-
-	if (!found) {
+	entry = _alarm_table_find(alarm_id);
+	if (entry == NULL) {
 		if (error_code)
 			*error_code = ERR_ALARM_INVALID_ID;
-		return false;
+		return NULL;
 	}
 
+	entry->pid = pid;
+	entry->quark_app_service_name = g_quark_from_string(app_service_name);
+	__alarm_set_start_and_end_time(alarm_info, entry);
+	memcpy(&(entry->alarm_info), alarm_info, sizeof(alarm_info_t));
+
+	/* _alarm_next_duetime() does not set due_time for an invalid
+	   repeat mode, and such an alarm is disabled */
+	entry->due_time = _alarm_next_duetime(entry);
+	_alarm_queue_update(entry);
+
 	if (!(alarm_info->alarm_type & ALARM_TYPE_VOLATILE)) {
-		_update_alarms(__alarm_info);
+		_update_alarms(entry);
 	}
 
-	return true;
+	return entry;
 }
 
 static bool __alarm_remove_from_list(int pid, alarm_id_t alarm_id,
 				     int *error_code)
 {
-	bool found = false;
-
 	alarm_info_t *alarm_info = NULL;
-
-	GSList *iter = NULL;
 	__alarm_info_t *entry = NULL;
 
-	/*list alarms */
 	ALARM_MGR_LOG_PRINT("[alarm-server]: before del : alarm id(%d)\n",
 			    alarm_id);
 
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		entry = iter->data;
-		if (entry->alarm_id == alarm_id) {
-			alarm_info = &entry->alarm_info;
-
-			ALARM_MGR_LOG_PRINT("[alarm-server]: "
-					    "__alarm_remove_from_list : alarm id(%d)\n",
-					    entry->alarm_id);
+	entry = _alarm_table_find(alarm_id);
+	if (entry == NULL) {
+		if (error_code)
+			*error_code = ERR_ALARM_INVALID_ID;
+		return false;
+	}
 
-			if (!(alarm_info->alarm_type & ALARM_TYPE_VOLATILE)) {
-				_delete_alarms(alarm_id);
-			}
+	alarm_info = &entry->alarm_info;
 
-			alarm_context.alarms =
-			    g_slist_remove(alarm_context.alarms, iter->data);
-			found = true;
-			break;
-		}
+	ALARM_MGR_LOG_PRINT("[alarm-server]: "
+			    "__alarm_remove_from_list : alarm id(%d)\n",
+			    entry->alarm_id);
 
+	if (!(alarm_info->alarm_type & ALARM_TYPE_VOLATILE)) {
+		_delete_alarms(alarm_id);
 	}
 
-	ALARM_MGR_LOG_PRINT("[alarm-server]: after del\n");
+	/* entry is freed here, so it must not be referenced any more */
+	_alarm_table_remove(alarm_id);
+	_alarm_id_free(alarm_id);
 
-	if (!found) {
-		if (error_code)
-			*error_code = ERR_ALARM_INVALID_ID;
-		return false;
-	}
+	ALARM_MGR_LOG_PRINT("[alarm-server]: after del\n");
 
 	return true;
 }
@@ -552,16 +519,14 @@ static bool __alarm_update_due_time_of_all_items_in_list(double diff_time)
 {
 	time_t current_time;
 	time_t min_time = -1;
-	time_t due_time = 0;
-	GSList *iter = NULL;
+	__alarm_table_iter_t iter;
 	__alarm_info_t *entry = NULL;
 	struct tm *p_time = NULL ;
 	struct tm due_time_result ;
 	struct tm fixed_time ;
 
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		entry = iter->data;
+	_alarm_table_iter_init(&iter);
+	while (_alarm_table_iter_next(&iter, &entry)) {
 		alarm_info_t *alarm_info = &(entry->alarm_info);
 		if (alarm_info->alarm_type & ALARM_TYPE_RELATIVE) {
 			/*diff_time ó */
@@ -606,44 +571,25 @@ static bool __alarm_update_due_time_of_all_items_in_list(double diff_time)
 
 			ALARM_MGR_LOG_PRINT("alarm_info->alarm_type is "
 					    "ALARM_TYPE_RELATIVE\n");
-
-			_update_alarms(entry);
 		}
 
 		_alarm_next_duetime(entry);
 		ALARM_MGR_LOG_PRINT("entry->due_time is %d\n", entry->due_time);
+
+		/* the saved due_time is the hint of the lazy boot */
+		if (!(alarm_info->alarm_type & ALARM_TYPE_VOLATILE))
+			_update_alarms(entry);
 	}
 
 	time(&current_time);
 
-	for (iter = alarm_context.alarms; iter != NULL;
-	     iter = g_slist_next(iter)) {
-		entry = iter->data;
-		due_time = entry->due_time;
-
-		double interval = 0;
-
-		ALARM_MGR_LOG_PRINT("alarm[%d] with duetime(%u) at "
-		"current(%u)\n", entry->alarm_id, due_time, current_time);
-		if (due_time == 0) {	/* 0 means this alarm has been 
-					   disabled */
-			continue;
-		}
-
-		interval = difftime(due_time, current_time);
-
-		if (interval <= 0) {
-			ALARM_MGR_LOG_PRINT("this may be error.. alarm[%d]\n", \
-					    entry->alarm_id);
-			continue;
-		}
-
-		interval = difftime(due_time, min_time);
-
-		if ((interval < 0) || min_time == -1) {
-			min_time = due_time;
-		}
+	/* due_time of every alarm has been changed, so the due-time queue is
+	   rebuilt at once instead of being updated alarm by alarm */
+	_alarm_queue_rebuild();
 
+	entry = _alarm_queue_first(current_time);
+	if (entry != NULL) {
+		min_time = entry->due_time;
 	}
 
 	alarm_context.c_due_time = min_time;
@@ -658,18 +604,10 @@ static bool __alarm_create_appsvc(alarm_info_t *alarm_info, alarm_id_t *alarm_id
 	time_t due_time;
 	struct tm ts_ret;
 	char due_time_r[100] = { 0 };
-	char proc_file[512] = { 0 };
-	char process_name[512] = { 0 };
-	char app_name[512] = { 0 };
-	char *word = NULL;
-	char *proc_name_ptr = NULL;
-	int fd = 0;
-	int ret = 0;
-	int i = 0;
 
 	__alarm_info_t *__alarm_info = NULL;
 
-	__alarm_info = malloc(sizeof(__alarm_info_t));
+	__alarm_info = _alarm_info_new();
 	if (__alarm_info == NULL) {
 		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid=%d, malloc "
 					  "failed. it seems to be OOM\n", pid);
@@ -681,50 +619,18 @@ static bool __alarm_create_appsvc(alarm_info_t *alarm_info, alarm_id_t *alarm_id
 	__alarm_info->alarm_id = -1;
 
 
-	/* we should consider to check whether  pid is running or Not
-	 */
-	memset(process_name, '\0', 512);
-	memset(proc_file, '\0', 512);
-	snprintf(proc_file, 512, "/proc/%d/cmdline", pid);
-
-	fd = open(proc_file, O_RDONLY);
-	if (fd > 0) {
-		ret = read(fd, process_name, 512);
-		close(fd);
-		if (ret <=0)
-		{
-			ALARM_MGR_EXCEPTION_PRINT("Unable to get application name\n");
-			*error_code = -1;
-			free(__alarm_info);
-			return false;
-		}
-		while (process_name[i] != '\0') {
-			if (process_name[i] == ' ') {
-				process_name[i] = '\0';
-				break;
-			}
-			i++;
-		}
-
-		word = strtok_r(process_name, "/", &proc_name_ptr);
-		while (word != NULL) {
-			memset(app_name, 0, 512);
-			snprintf(app_name, 512, "%s", word);
-			word = strtok_r(NULL, "/", &proc_name_ptr);
-		}
-		__alarm_info->quark_app_unique_name =
-		    g_quark_from_string(app_name);
-	} else {		/* failure */
+	if (!_alarm_app_name_lookup(pid,
+				    &__alarm_info->quark_app_unique_name)) {
 		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid(%d) seems to be "
-					  "killed, so we failed to get proc file(%s) and do not create "
-					  "alarm_info\n", pid, proc_file);
+					  "killed, so we do not create "
+					  "alarm_info\n", pid);
 		*error_code = -1;	/*-1 means that system failed 
 							internally.*/
-		free(__alarm_info);
+		_alarm_info_free(__alarm_info);
 		return false;
 	}
 
-	__alarm_info->quark_bundle=g_quark_from_string(bundle_data);
+	__alarm_info->bundle = _alarm_bundle_get(bundle_data);
 	__alarm_info->quark_app_service_name = g_quark_from_string("null");
 	__alarm_info->quark_dst_service_name = g_quark_from_string("null");
 	__alarm_info->quark_app_service_name_mod = g_quark_from_string("null");
@@ -744,7 +650,7 @@ static bool __alarm_create_appsvc(alarm_info_t *alarm_info, alarm_id_t *alarm_id
 
 	due_time = _alarm_next_duetime(__alarm_info);
 	if (__alarm_add_to_list(__alarm_info, alarm_id) == false) {
-		free(__alarm_info);
+		_alarm_info_free(__alarm_info);
 		*error_code = -1;
 		return false;
 	}
@@ -773,14 +679,12 @@ static bool __alarm_create_appsvc(alarm_info_t *alarm_info, alarm_id_t *alarm_id
 			    "due_time(%d)", alarm_context.c_due_time, due_time);
 
 	if (alarm_context.c_due_time == -1
-	    || due_time < alarm_context.c_due_time) {
-		_clear_scheduled_alarm_list();
-		_add_to_scheduled_alarm_list(__alarm_info);
-		_alarm_set_timer(&alarm_context, alarm_context.timer, due_time,
-				 *alarm_id);
-		alarm_context.c_due_time = due_time;
+	    || _alarm_deadline(__alarm_info) < alarm_context.c_due_time) {
+		/* the timer is armed earlier, and the alarms due by then are
+		   expired with this one */
+		_alarm_schedule();
 
-	} else if (due_time == alarm_context.c_due_time) {
+	} else if (due_time <= alarm_context.c_due_time) {
 		_add_to_scheduled_alarm_list(__alarm_info);
 
 	}
@@ -805,15 +709,10 @@ static bool __alarm_create(alarm_info_t *alarm_info, alarm_id_t *alarm_id,
 
 	time_t current_time;
 	time_t due_time;
-	char proc_file[256] = { 0 };
-	char process_name[512] = { 0 };
-	char app_name[256] = { 0 };
-	char *word = NULL;
-	char *proc_name_ptr = NULL;
 
 	__alarm_info_t *__alarm_info = NULL;
 
-	__alarm_info = malloc(sizeof(__alarm_info_t));
+	__alarm_info = _alarm_info_new();
 	if (__alarm_info == NULL) {
 		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid=%d, malloc "
 					  "failed. it seems to be OOM\n", pid);
@@ -824,47 +723,14 @@ static bool __alarm_create(alarm_info_t *alarm_info, alarm_id_t *alarm_id,
 	__alarm_info->pid = pid;
 	__alarm_info->alarm_id = -1;
 
-	/* we should consider to check whether  pid is running or Not
-	 */
-	memset(process_name, '\0', 512);
-	memset(proc_file, '\0', 256);
-	snprintf(proc_file, 256, "/proc/%d/cmdline", pid);
-
-	int fd;
-	int ret;
-	int i = 0;
-	fd = open(proc_file, O_RDONLY);
-	if (fd > 0) {
-		ret = read(fd, process_name, 512);
-		close(fd);
-		while (process_name[i] != '\0') {
-			if (process_name[i] == ' ') {
-				process_name[i] = '\0';
-				break;
-			}
-			i++;
-		}
-		/* if (readlink(proc_file, process_name, 256)!=-1) */
-		/*success */
-
-		word = strtok_r(process_name, "/", &proc_name_ptr);
-		while (word != NULL) {
-			memset(app_name, 0, 256);
-			snprintf(app_name, 256, "%s", word);
-			word = strtok_r(NULL, "/", &proc_name_ptr);
-		}
-		__alarm_info->quark_app_unique_name =
-		    g_quark_from_string(app_name);
-	} else {		/* failure */
-
-		__alarm_info->quark_app_unique_name =
-		    g_quark_from_string("unknown");
+	if (!_alarm_app_name_lookup(pid,
+				    &__alarm_info->quark_app_unique_name)) {
 		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid(%d) seems to be "
-					  "killed, so we failed to get proc file(%s) and do not create "
-					  "alarm_info\n", pid, proc_file);
+					  "killed, so we do not create "
+					  "alarm_info\n", pid);
 		*error_code = -1;	/*-1 means that system failed 
 							internally.*/
-		free(__alarm_info);
+		_alarm_info_free(__alarm_info);
 		return false;
 	}
 
@@ -876,7 +742,7 @@ static bool __alarm_create(alarm_info_t *alarm_info, alarm_id_t *alarm_id,
 	    g_quark_from_string(dst_service_name);
 	__alarm_info->quark_dst_service_name_mod =
 	    g_quark_from_string(dst_service_name_mod);
-	__alarm_info->quark_bundle = g_quark_from_string("null");
+	__alarm_info->bundle = NULL;
 
 
 	__alarm_set_start_and_end_time(alarm_info, __alarm_info);
@@ -900,10 +766,13 @@ static bool __alarm_create(alarm_info_t *alarm_info, alarm_id_t *alarm_id,
 
 	due_time = _alarm_next_duetime(__alarm_info);
 	if (__alarm_add_to_list(__alarm_info, alarm_id) == false) {
-		free(__alarm_info);
+		_alarm_info_free(__alarm_info);
 		return false;
 	}
 
+	if (alarm_batch_depth > 0)
+		return true;
+
 	if (due_time == 0) {
 		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:Create a new alarm: "
 		"due_time is 0, alarm(%d) \n", *alarm_id);
@@ -930,14 +799,12 @@ static bool __alarm_create(alarm_info_t *alarm_info, alarm_id_t *alarm_id,
 			    "due_time(%d)", alarm_context.c_due_time, due_time);
 
 	if (alarm_context.c_due_time == -1
-	    || due_time < alarm_context.c_due_time) {
-		_clear_scheduled_alarm_list();
-		_add_to_scheduled_alarm_list(__alarm_info);
-		_alarm_set_timer(&alarm_context, alarm_context.timer, due_time,
-				 *alarm_id);
-		alarm_context.c_due_time = due_time;
+	    || _alarm_deadline(__alarm_info) < alarm_context.c_due_time) {
+		/* the timer is armed earlier, and the alarms due by then are
+		   expired with this one */
+		_alarm_schedule();
 
-	} else if (due_time == alarm_context.c_due_time) {
+	} else if (due_time <= alarm_context.c_due_time) {
 		_add_to_scheduled_alarm_list(__alarm_info);
 
 	}
@@ -966,26 +833,9 @@ static bool __alarm_update(int pid, char *app_service_name, alarm_id_t alarm_id,
 	__alarm_info_t *__alarm_info = NULL;
 	bool result = false;
 
-	__alarm_info = malloc(sizeof(__alarm_info_t));
-	if (__alarm_info == NULL) {
-		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid=%d, "
-			"malloc failed. it seems to be OOM\n", pid);
-		*error_code = -1;	/*-1 means that system failed 
-						internally.*/
-		return false;
-	}
-
-	__alarm_info->pid = pid;
-	__alarm_info->alarm_id = alarm_id;
-
 	/* we should consider to check whether  pid is running or Not
 	 */
 
-	__alarm_info->quark_app_service_name =
-	    g_quark_from_string(app_service_name);
-	__alarm_set_start_and_end_time(alarm_info, __alarm_info);
-	memcpy(&(__alarm_info->alarm_info), alarm_info, sizeof(alarm_info_t));
-
 	time(&current_time);
 
 	if (alarm_context.c_due_time < current_time) {
@@ -995,13 +845,15 @@ static bool __alarm_update(int pid, char *app_service_name, alarm_id_t alarm_id,
 		alarm_context.c_due_time = -1;
 	}
 
-	due_time = _alarm_next_duetime(__alarm_info);
-	if (!__alarm_update_in_list(pid, alarm_id, __alarm_info, error_code)) {
-		free(__alarm_info);
+	__alarm_info = __alarm_update_in_list(pid, app_service_name, alarm_id,
+					      alarm_info, error_code);
+	if (__alarm_info == NULL) {
 		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]: requested alarm_id "
 		"(%d) does not exist. so this value is invalid id.", alarm_id);
 		return false;
 	}
+	due_time = __alarm_info->due_time;
+
 	/* ALARM_MGR_LOG_PRINT("[alarm-server]:request_pid=%d, alarm_id=%d, 
 	 * app_unique_name=%s, app_service_name=%s, dst_service_name=%s, 
 	 * c_due_time=%d", pid, alarm_id, g_quark_to_string
@@ -1037,20 +889,17 @@ static bool __alarm_update(int pid, char *app_service_name, alarm_id_t alarm_id,
 			ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:Update alarm: "
 					"due_time is 0\n");
 		}
-		free(__alarm_info);
 		return true;
 	}
 
 	if (due_time == 0) {
 		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:Update alarm: "
 				"due_time is 0, alarm(%d)\n", alarm_id);
-		free(__alarm_info);
 		return true;
 	} else if (current_time == due_time) {
 		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]:Update alarm: "
 		"current_time(%d) is same as due_time(%d)", current_time,
 		due_time);
-		free(__alarm_info);
 		return true;
 	}else if (difftime(due_time, current_time)< 0){
 		ALARM_MGR_EXCEPTION_PRINT("[alarm-server]: Expired Due Time.[Due time=%d, Current Time=%d]!!!Do not add to schedule list\n", due_time, current_time);
@@ -1068,15 +917,11 @@ static bool __alarm_update(int pid, char *app_service_name, alarm_id_t alarm_id,
 			    "due_time(%d)", alarm_context.c_due_time, due_time);
 
 	if (alarm_context.c_due_time == -1
-	    || due_time < alarm_context.c_due_time) {
-		_clear_scheduled_alarm_list();
-		_add_to_scheduled_alarm_list(__alarm_info);
-		_alarm_set_timer(&alarm_context, alarm_context.timer, due_time,
-				 alarm_id);
-		alarm_context.c_due_time = due_time;
+	    || _alarm_deadline(__alarm_info) < alarm_context.c_due_time) {
+		_alarm_schedule();
 		ALARM_MGR_LOG_PRINT("[alarm-server1]:alarm_context.c_due_time "
 		     "(%d), due_time(%d)", alarm_context.c_due_time, due_time);
-	} else if (due_time == alarm_context.c_due_time) {
+	} else if (due_time <= alarm_context.c_due_time) {
 		_add_to_scheduled_alarm_list(__alarm_info);
 		ALARM_MGR_LOG_PRINT("[alarm-server2]:alarm_context.c_due_time "
 		     "(%d), due_time(%d)", alarm_context.c_due_time, due_time);
@@ -1114,6 +959,9 @@ static bool __alarm_delete(int pid, alarm_id_t alarm_id, int *error_code)
 		return false;
 	}
 
+	if (alarm_batch_depth > 0)
+		return true;
+
 	if (result == true && g_slist_length(g_scheduled_alarm_list) == 0) {
 		_alarm_disable_timer(alarm_context);
 		_alarm_schedule();
@@ -1244,6 +1092,8 @@ static bool __alarm_power_on(int app_id, bool on_off, int *error_code)
 
 static bool __alarm_power_off(int app_id, int *error_code)
 {
+	_registry_flush();
+
 #ifdef __ALARM_BOOT
 
 #endif				/* #ifdef __ALARM_BOOT */
@@ -1325,24 +1175,156 @@ static void __alarm_send_noti_to_application(const char *app_service_name,
 		return;
 	}
 
+	/* the message is not flushed here : it is written at once when the
+	   outgoing queue is empty, and the main loop writes the rest when the
+	   socket is writable, so alarms expired together are not serialized
+	   on blocking writes */
 	dbus_connection_send(dbus_g_connection_get_connection
 			     (alarm_context.bus), message, NULL);
-	dbus_connection_flush(dbus_g_connection_get_connection
-			      (alarm_context.bus));
 	dbus_message_unref(message);
 
 }
 
-static void __alarm_expired()
+/*
+ * Delivers an expired alarm. It is called by the dispatch pipeline, from a
+ * worker thread unless the pipeline is disabled, so it must not touch the
+ * alarm table or the scheduled alarm list.
+ */
+static void __alarm_deliver(__alarm_delivery_t *delivery)
 {
 	const char *destination_app_service_name = NULL;
-	alarm_id_t alarm_id = -1;
-	int app_pid = 0;
-	__alarm_info_t *__alarm_info = NULL;
+	alarm_id_t alarm_id = delivery->alarm_id;
+	int app_pid = delivery->pid;
 	char alarm_id_val[32]={0,};
-	int b_len = 0;
 	bundle *b = NULL;
 
+	if (delivery->bundle != NULL) {
+
+			b = _alarm_bundle_dup_decoded(delivery->bundle);
+
+			if (NULL == b)
+			{
+				ALARM_MGR_EXCEPTION_PRINT("Error!!!..Unable to decode the bundle!!\n");
+			}
+			else
+			{
+				snprintf(alarm_id_val,31,"%d",alarm_id);
+
+				if (bundle_add(b,"http://tizen.org/appcontrol/data/alarm_id", alarm_id_val)){
+					ALARM_MGR_EXCEPTION_PRINT("Unable to add alarm id to the bundle\n");
+				}
+				else
+				{
+					if ( appsvc_run_service(b, 0, NULL, NULL) < 0)
+					{
+						ALARM_MGR_EXCEPTION_PRINT("Unable to run app svc\n");
+					}
+					else
+					{
+						ALARM_MGR_LOG_PRINT("Successfuly ran app svc\n");
+					}
+				}
+				bundle_free(b);
+			}
+
+	}
+	else
+	{
+		if (strncmp
+		    (g_quark_to_string(delivery->quark_dst_service_name),
+		     "null",4) == 0) {
+			ALARM_MGR_LOG_PRINT("[alarm-server]:destination is "
+			"null, so we send expired alarm to %s(%u)\n",\
+				g_quark_to_string(
+				delivery->quark_app_service_name),
+				delivery->quark_app_service_name); 
+				destination_app_service_name = g_quark_to_string(
+				delivery->quark_app_service_name_mod);
+		} else {
+			ALARM_MGR_LOG_PRINT("[alarm-server]:destination "
+					    ":%s(%u)\n",
+				g_quark_to_string(
+				delivery->quark_dst_service_name), 
+				delivery->quark_dst_service_name);
+				destination_app_service_name = g_quark_to_string(
+					delivery->quark_dst_service_name_mod);
+		}
+
+		/* 
+		 * we should consider a situation that 
+		 * destination_app_service_name is owner_name like (:xxxx) and
+		 * application's pid which registered this alarm was killed.In that case,
+		 * we don't need to send the expire event because the process was killed.
+		 * this causes needless message to be sent.
+		 */
+		ALARM_MGR_LOG_PRINT("[alarm-server]: "
+				    "destination_app_service_name :%s, app_pid=%d\n",
+				    destination_app_service_name, app_pid);
+		/* the following is a code that checks the above situation. 
+		   please verify this code. */
+
+		if (!_alarm_name_has_owner(destination_app_service_name)) {
+			__expired_alarm_t *expire_info;
+			char pkg_name[MAX_SERVICE_NAME_LEN] = { 0, };
+			char alarm_id_str[32] = { 0, };
+
+			expire_info = malloc(sizeof(__expired_alarm_t));
+			if (G_UNLIKELY(NULL == expire_info)){
+				ALARM_MGR_ASSERT_PRINT("[alarm-server]:Malloc failed!Can't notify alarm expiry info\n");
+				return;
+			}
+			strncpy(expire_info->service_name,
+				destination_app_service_name,
+				MAX_SERVICE_NAME_LEN);
+			expire_info->alarm_id = alarm_id;
+
+			/* it is sent by the filter when the application
+			   owns the name, so it is queued before the launch */
+			G_LOCK(expired_alarm_list);
+			g_expired_alarm_list =
+			    g_slist_append(g_expired_alarm_list, expire_info);
+			G_UNLOCK(expired_alarm_list);
+
+
+			if (strncmp
+		    		(g_quark_to_string(delivery->quark_dst_service_name),
+				     "null",4) == 0) {
+				strncpy(pkg_name,g_quark_to_string(delivery->quark_app_service_name),strlen(g_quark_to_string(delivery->quark_app_service_name))-6);
+			}
+			else
+			{
+				strncpy(pkg_name,g_quark_to_string(delivery->quark_dst_service_name),strlen(g_quark_to_string(delivery->quark_dst_service_name))-6);
+			}
+
+			snprintf(alarm_id_str, 31, "%d", alarm_id);
+
+			ALARM_MGR_LOG_PRINT("before aul_launch pkg_name(%s) "
+				"alarm_id_str(%s)\n", pkg_name, alarm_id_str);
+
+			bundle *kb;
+			kb = bundle_create();
+			bundle_add(kb, "__ALARM_MGR_ID", alarm_id_str);
+			aul_launch_app(pkg_name, kb);
+			bundle_free(kb);
+		} else {
+			ALARM_MGR_LOG_PRINT(
+				"before alarm_send_noti_to_application\n");
+			__alarm_send_noti_to_application(
+				     destination_app_service_name, alarm_id);
+		}
+	}
+	ALARM_MGR_LOG_PRINT("after __alarm_send_noti_to_application\n");
+}
+
+/*
+ * Hands the scheduled alarms to the dispatch pipeline, and reschedules or
+ * removes them on the main loop.
+ */
+static void __alarm_expired()
+{
+	alarm_id_t alarm_id = -1;
+	__alarm_info_t *__alarm_info = NULL;
+
 	ALARM_MGR_LOG_PRINT("[alarm-server]: Enter \n");
 
 	time_t current_time;
@@ -1370,144 +1352,27 @@ static void __alarm_expired()
 
 		__alarm_info = alarm->__alarm_info;
 
-		app_pid = __alarm_info->pid;
-
-		if (strncmp
-		    (g_quark_to_string(__alarm_info->quark_bundle),
-		     "null", 4) != 0) {
-
-				b_len = strlen(g_quark_to_string(__alarm_info->quark_bundle));
-
-				b = bundle_decode((bundle_raw *)g_quark_to_string(__alarm_info->quark_bundle), b_len);
-
-				if (NULL == b)
-				{
-					ALARM_MGR_EXCEPTION_PRINT("Error!!!..Unable to decode the bundle!!\n");
-				}
-				else
-				{
-					snprintf(alarm_id_val,31,"%d",alarm_id);
-
-					if (bundle_add(b,"http://tizen.org/appcontrol/data/alarm_id", alarm_id_val)){
-						ALARM_MGR_EXCEPTION_PRINT("Unable to add alarm id to the bundle\n");
-					}
-					else
-					{
-						if ( appsvc_run_service(b, 0, NULL, NULL) < 0)
-						{
-							ALARM_MGR_EXCEPTION_PRINT("Unable to run app svc\n");
-						}
-						else
-						{
-							ALARM_MGR_LOG_PRINT("Successfuly ran app svc\n");
-						}
-					}
-					bundle_free(b);
-				}
-
-		}
-		else
-		{
-			if (strncmp
-			    (g_quark_to_string(__alarm_info->quark_dst_service_name),
-			     "null",4) == 0) {
-				ALARM_MGR_LOG_PRINT("[alarm-server]:destination is "
-				"null, so we send expired alarm to %s(%u)\n",\
-					g_quark_to_string(
-					__alarm_info->quark_app_service_name),
-					__alarm_info->quark_app_service_name); 
-					destination_app_service_name = g_quark_to_string(
-					__alarm_info->quark_app_service_name_mod);
-			} else {
-				ALARM_MGR_LOG_PRINT("[alarm-server]:destination "
-						    ":%s(%u)\n",
-					g_quark_to_string(
-					__alarm_info->quark_dst_service_name), 
-					__alarm_info->quark_dst_service_name);
-					destination_app_service_name = g_quark_to_string(
-						__alarm_info->quark_dst_service_name_mod);
-			}
-
 #ifdef __ALARM_BOOT
-			/* orginally this code had if(__alarm_info->app_id==21) in a 
-			   platform with app-server. */
-			/*if(__alarm_info->quark_dst_service_name  == 
-			   g_quark_from_string (WAKEUP_ALARM_APP_ID)) */
-			if (strcmp
-			    (g_quark_to_string(__alarm_info->quark_dst_service_name),
-			     WAKEUP_ALARM_APP_ID) == 0) {
-				int fd = 0;
-				fd = open(power_rtc, O_RDONLY);
-				if (fd < 0) {
-					ALARM_MGR_LOG_PRINT("cannot open /dev/rtc0\n");
-				} else {
-					ioctl(fd, RTC_AIE_OFF, 0);
-					close(fd);
-				}
-			}
-#endif
-
-			/* 
-			 * we should consider a situation that 
-			 * destination_app_service_name is owner_name like (:xxxx) and
-			 * application's pid which registered this alarm was killed.In that case,
-			 * we don't need to send the expire event because the process was killed.
-			 * this causes needless message to be sent.
-			 */
-			ALARM_MGR_LOG_PRINT("[alarm-server]: "
-					    "destination_app_service_name :%s, app_pid=%d\n",
-					    destination_app_service_name, app_pid);
-			/* the following is a code that checks the above situation. 
-			   please verify this code. */
-
-			if (dbus_bus_name_has_owner(
-			     dbus_g_connection_get_connection(alarm_context.bus),
-			     destination_app_service_name, NULL) == FALSE) {
-				__expired_alarm_t *expire_info;
-				char pkg_name[MAX_SERVICE_NAME_LEN] = { 0, };
-				char alarm_id_str[32] = { 0, };
-
-				expire_info = malloc(sizeof(__expired_alarm_t));
-				if (G_UNLIKELY(NULL == expire_info)){
-					ALARM_MGR_ASSERT_PRINT("[alarm-server]:Malloc failed!Can't notify alarm expiry info\n");
-					goto done;
-				}
-				strncpy(expire_info->service_name,
-					destination_app_service_name,
-					MAX_SERVICE_NAME_LEN);
-				expire_info->alarm_id = alarm_id;
-				g_expired_alarm_list =
-				    g_slist_append(g_expired_alarm_list, expire_info);
-
-
-				if (strncmp
-			    		(g_quark_to_string(__alarm_info->quark_dst_service_name),
-					     "null",4) == 0) {
-					strncpy(pkg_name,g_quark_to_string(__alarm_info->quark_app_service_name),strlen(g_quark_to_string(__alarm_info->quark_app_service_name))-6);
-				}
-				else
-				{
-					strncpy(pkg_name,g_quark_to_string(__alarm_info->quark_dst_service_name),strlen(g_quark_to_string(__alarm_info->quark_dst_service_name))-6);
-				}
-
-				snprintf(alarm_id_str, 31, "%d", alarm_id);
-
-				ALARM_MGR_LOG_PRINT("before aul_launch pkg_name(%s) "
-					"alarm_id_str(%s)\n", pkg_name, alarm_id_str);
-
-				bundle *kb;
-				kb = bundle_create();
-				bundle_add(kb, "__ALARM_MGR_ID", alarm_id_str);
-				aul_launch_app(pkg_name, kb);
-				bundle_free(kb);
+		/* orginally this code had if(__alarm_info->app_id==21) in a 
+		   platform with app-server. */
+		/* the RTC alarm is turned off here, in order with the
+		   __rtc_set() which arms the next one, not by the dispatch
+		   thread */
+		if (__alarm_info->bundle == NULL
+		    && __alarm_info->quark_dst_service_name ==
+		    g_quark_from_string(WAKEUP_ALARM_APP_ID)) {
+			int fd = 0;
+			fd = open(power_rtc, O_RDONLY);
+			if (fd < 0) {
+				ALARM_MGR_LOG_PRINT("cannot open /dev/rtc0\n");
 			} else {
-				ALARM_MGR_LOG_PRINT(
-					"before alarm_send_noti_to_application\n");
-				__alarm_send_noti_to_application(
-					     destination_app_service_name, alarm_id);
+				ioctl(fd, RTC_AIE_OFF, 0);
+				close(fd);
 			}
 		}
-		ALARM_MGR_LOG_PRINT("after __alarm_send_noti_to_application\n");
+#endif
+
+		_alarm_dispatch_push(__alarm_info, alarm_context.c_due_time);
 
 /*		if( !(__alarm_info->alarm_info.alarm_type 
 					& ALARM_TYPE_VOLATILE) ) {
@@ -1524,11 +1389,18 @@ static void __alarm_expired()
 		} else {
 
 			_alarm_next_duetime(__alarm_info);
-/*                      _update_alarms(__alarm_info);*/
+			_alarm_queue_update(__alarm_info);
+			/* the saved due_time is the hint of the lazy boot */
+			if (!(__alarm_info->alarm_info.alarm_type
+			      & ALARM_TYPE_VOLATILE))
+				_update_alarms(__alarm_info);
 		}
 
 	}
 
+	/* the alarms are delivered in the order of the scheduled list */
+	_alarm_dispatch_flush();
+
  done:
 	_clear_scheduled_alarm_list();
 	alarm_context.c_due_time = -1;
@@ -1536,6 +1408,12 @@ static void __alarm_expired()
 	ALARM_MGR_LOG_PRINT("[alarm-server]: Leave  \n");
 }
 
+static gboolean __alarm_delivered_idle(gpointer data)
+{
+	pm_unlock_state(LCD_OFF, PM_SLEEP_MARGIN);
+	return false;
+}
+
 static gboolean __alarm_handler_idle()
 {
 	if (g_dummy_timer_is_set == true) {
@@ -1562,7 +1440,8 @@ static gboolean __alarm_handler_idle()
 		__alarm_power_on(0, enable_power_on_alarm, NULL);
 	}
 #endif
-	pm_unlock_state(LCD_OFF, PM_SLEEP_MARGIN);
+	/* the device is kept awake until the expired alarms are delivered */
+	_alarm_dispatch_barrier(__alarm_delivered_idle, NULL);
 	return false;
 
 }
@@ -1653,11 +1532,8 @@ gboolean alarm_manager_alarm_set_rtc_time(void *pObject, int pid,
 				int year, int mon, int day,
 				int hour, int min, int sec, char *e_cookie,
 				int *return_code){
-	guchar *cookie = NULL;
-	gsize size;
 	int retval = 0;
 	gboolean result = true;
-	gid_t call_gid;
 
 	const char *rtc = power_rtc;
 	int fd = 0;
@@ -1671,26 +1547,7 @@ gboolean alarm_manager_alarm_set_rtc_time(void *pObject, int pid,
 		*return_code = ALARMMGR_RESULT_SUCCESS;
 	}
 
-	cookie = g_base64_decode(e_cookie, &size);
-	if (NULL == cookie)
-	{
-		if (return_code)
-			*return_code = ERR_ALARM_NO_PERMISSION;
-		ALARM_MGR_EXCEPTION_PRINT("Unable to decode cookie!!!\n");
-		return true;
-	}
-
-	call_gid = security_server_get_gid("alarm");
-
-	ALARM_MGR_LOG_PRINT("call_gid : %d\n", call_gid);
-
-	retval = security_server_check_privilege((const char *)cookie, call_gid);
-	if (retval < 0) {
-		if (retval == SECURITY_SERVER_API_ERROR_ACCESS_DENIED) {
-			ALARM_MGR_EXCEPTION_PRINT(
-				"%s", "access has been denied\n");
-		}
-		ALARM_MGR_EXCEPTION_PRINT("Error has occurred in security_server_check_privilege()\n");
+	if (!_alarm_privilege_check(e_cookie)) {
 		if (return_code)
 			*return_code = ERR_ALARM_NO_PERMISSION;
 	}
@@ -1769,11 +1626,6 @@ gboolean alarm_manager_alarm_set_rtc_time(void *pObject, int pid,
 		}
 	}
 
-	if (cookie){
-		g_free(cookie);
-		cookie = NULL;
-	}
-
 	return result;
 
 }
@@ -1790,10 +1642,6 @@ gboolean alarm_manager_alarm_create_appsvc(void *pObject, int pid,
 				    int *alarm_id, int *return_code)
 {
 	alarm_info_t alarm_info;
-	guchar *cookie = NULL;
-	gsize size;
-	int retval = 0;
-	gid_t call_gid;
 	gboolean result = true;
 
 	alarm_info.start.year = start_year;
@@ -1815,27 +1663,8 @@ gboolean alarm_manager_alarm_create_appsvc(void *pObject, int pid,
 
 	*return_code = 0;
 
-	cookie = g_base64_decode(e_cookie, &size);
-	if (NULL == cookie)
-	{
-		*return_code = -1;
-		ALARM_MGR_EXCEPTION_PRINT("Unable to decode cookie!!!\n");
-		return false;
-	}
-	
-	call_gid = security_server_get_gid("alarm");
-
-	ALARM_MGR_LOG_PRINT("call_gid : %d\n", call_gid);
-
-	retval = security_server_check_privilege((const char *)cookie, call_gid);
-	if (retval < 0) {
-		if (retval == SECURITY_SERVER_API_ERROR_ACCESS_DENIED) {
-			ALARM_MGR_EXCEPTION_PRINT(
-				"%s", "access has been denied\n");
-		}
-		ALARM_MGR_EXCEPTION_PRINT("Error has occurred in security_server_check_privilege()\n");
-		*return_code = -1;
-		result = false;
+	if (!_alarm_privilege_check(e_cookie)) {
+		*return_code = ERR_ALARM_NO_PERMISSION;
 	}
 	else {
 		result = __alarm_create_appsvc(&alarm_info, alarm_id, pid,
@@ -1846,11 +1675,6 @@ gboolean alarm_manager_alarm_create_appsvc(void *pObject, int pid,
 		}
 	}
 
-	if (cookie){
-		g_free(cookie);
-		cookie = NULL;
-	}
-
 	return result;
 }
 
@@ -1866,10 +1690,6 @@ gboolean alarm_manager_alarm_create(void *pObject, int pid,
 				    int *alarm_id, int *return_code)
 {
 	alarm_info_t alarm_info;
-	guchar *cookie;
-	gsize size;
-	int retval;
-	gid_t call_gid;
 
 	alarm_info.start.year = start_year;
 	alarm_info.start.month = start_month;
@@ -1890,20 +1710,8 @@ gboolean alarm_manager_alarm_create(void *pObject, int pid,
 
 	*return_code = 0;
 
-	cookie = g_base64_decode(e_cookie, &size);
-	call_gid = security_server_get_gid("alarm");
-
-	ALARM_MGR_LOG_PRINT("call_gid : %d\n", call_gid);
-
-	retval = security_server_check_privilege((const char *)cookie, call_gid);
-	if (retval < 0) {
-		if (retval == SECURITY_SERVER_API_ERROR_ACCESS_DENIED) {
-			ALARM_MGR_EXCEPTION_PRINT(
-				"%s", "access has been denied\n");
-		}
-		ALARM_MGR_EXCEPTION_PRINT("%s", "Error has occurred\n");
-
-		*return_code = -1;
+	if (!_alarm_privilege_check(e_cookie)) {
+		*return_code = ERR_ALARM_NO_PERMISSION;
 	}
 
 	else {
@@ -1912,40 +1720,174 @@ gboolean alarm_manager_alarm_create(void *pObject, int pid,
 			       reserved_service_name, reserved_service_name_mod, return_code);
 	}
 
-	g_free(cookie);
-
 	return true;
 }
 
 gboolean alarm_manager_alarm_delete(void *pObject, int pid, alarm_id_t alarm_id,
 				    char *e_cookie, int *return_code)
 {
-	guchar *cookie;
-	gsize size;
-	int retval;
-	gid_t call_gid;
+	if (!_alarm_privilege_check(e_cookie)) {
+		*return_code = ERR_ALARM_NO_PERMISSION;
+	}
+
+	else {
+		__alarm_delete(pid, alarm_id, return_code);
+	}
+
+	return true;
+}
+
+static void __alarm_batch_begin()
+{
+	alarm_batch_depth++;
+}
+
+/* schedules the alarms created or deleted since __alarm_batch_begin() */
+static void __alarm_batch_end()
+{
+	if (--alarm_batch_depth > 0)
+		return;
+
+	_alarm_schedule();
+	if (g_slist_length(g_scheduled_alarm_list) == 0)
+		_alarm_disable_timer(alarm_context);
+
+	__rtc_set();
+
+#ifdef __ALARM_BOOT
+	/*alarm boot */
+	if (enable_power_on_alarm) {
+		__alarm_power_on(0, enable_power_on_alarm, NULL);
+	}
+#endif
+}
+
+/*
+ * alarm_info is ALARM_INFO_PACKED_LEN ints per alarm. An id and an error
+ * code are returned for each alarm in the order of the request, and the
+ * id is -1 for an alarm which is not created.
+ */
+gboolean alarm_manager_alarm_create_batch(void *pObject, int pid,
+				char *app_service_name,
+				char *app_service_name_mod,
+				GArray *alarm_infos,
+				char *reserved_service_name,
+				char *reserved_service_name_mod, char *e_cookie,
+				GArray **alarm_ids, GArray **return_codes,
+				int *return_code)
+{
+	alarm_info_t alarm_info;
+	alarm_id_t alarm_id;
+	int error_code;
+	int *packed;
+	int count;
+	int i;
+
+	*return_code = 0;
+	*alarm_ids = g_array_new(false, true, sizeof(alarm_id_t));
+	*return_codes = g_array_new(false, true, sizeof(int));
+
+	if (alarm_infos == NULL
+	    || alarm_infos->len % ALARM_INFO_PACKED_LEN != 0
+	    || alarm_infos->len / ALARM_INFO_PACKED_LEN > ALARM_BATCH_MAX) {
+		*return_code = ERR_ALARM_INVALID_PARAM;
+		return true;
+	}
 
-	cookie = g_base64_decode(e_cookie, &size);
-	call_gid = security_server_get_gid("alarm");
+	if (!_alarm_privilege_check(e_cookie)) {
+		*return_code = ERR_ALARM_NO_PERMISSION;
+		return true;
+	}
+
+	count = alarm_infos->len / ALARM_INFO_PACKED_LEN;
+
+	__alarm_batch_begin();
+
+	for (i = 0; i < count; i++) {
+		packed = &g_array_index(alarm_infos, int,
+					i * ALARM_INFO_PACKED_LEN);
+
+		alarm_info.start.year = packed[0];
+		alarm_info.start.month = packed[1];
+		alarm_info.start.day = packed[2];
+		alarm_info.start.hour = packed[3];
+		alarm_info.start.min = packed[4];
+		alarm_info.start.sec = packed[5];
+
+		alarm_info.end.year = packed[6];
+		alarm_info.end.month = packed[7];
+		alarm_info.end.day = packed[8];
 
-	ALARM_MGR_LOG_PRINT("call_gid : %d\n", call_gid);
+		alarm_info.mode.u_interval.day_of_week = packed[9];
+		alarm_info.mode.repeat = packed[10];
 
-	retval = security_server_check_privilege((const char *)cookie, call_gid);
-	if (retval < 0) {
-		if (retval == SECURITY_SERVER_API_ERROR_ACCESS_DENIED) {
-			ALARM_MGR_EXCEPTION_PRINT("%s",
-						  "access has been denied\n");
+		alarm_info.alarm_type = packed[11];
+		alarm_info.reserved_info = packed[12];
+
+		alarm_id = -1;
+		error_code = 0;
+		if (!__alarm_create(&alarm_info, &alarm_id, pid,
+				    app_service_name, app_service_name_mod,
+				    reserved_service_name,
+				    reserved_service_name_mod, &error_code)) {
+			alarm_id = -1;
+			if (error_code == 0)
+				error_code = -1;
 		}
-		ALARM_MGR_EXCEPTION_PRINT("%s", "Error has occurred\n");
 
-		*return_code = -1;
+		g_array_append_val(*alarm_ids, alarm_id);
+		g_array_append_val(*return_codes, error_code);
 	}
 
-	else {
-		__alarm_delete(pid, alarm_id, return_code);
+	__alarm_batch_end();
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:%d alarms are created in a batch "
+			    "for pid(%d)\n", count, pid);
+
+	return true;
+}
+
+/* an error code is returned for each alarm in the order of the request */
+gboolean alarm_manager_alarm_delete_batch(void *pObject, int pid,
+					  GArray *alarm_id_array,
+					  char *e_cookie,
+					  GArray **return_codes,
+					  int *return_code)
+{
+	alarm_id_t alarm_id;
+	int error_code;
+	int i;
+
+	*return_code = 0;
+	*return_codes = g_array_new(false, true, sizeof(int));
+
+	if (alarm_id_array == NULL || alarm_id_array->len > ALARM_BATCH_MAX) {
+		*return_code = ERR_ALARM_INVALID_PARAM;
+		return true;
+	}
+
+	if (!_alarm_privilege_check(e_cookie)) {
+		*return_code = ERR_ALARM_NO_PERMISSION;
+		return true;
+	}
+
+	__alarm_batch_begin();
+
+	for (i = 0; i < alarm_id_array->len; i++) {
+		alarm_id = g_array_index(alarm_id_array, alarm_id_t, i);
+
+		error_code = 0;
+		if (!__alarm_delete(pid, alarm_id, &error_code)
+		    && error_code == 0)
+			error_code = -1;
+
+		g_array_append_val(*return_codes, error_code);
 	}
 
-	g_free(cookie);
+	__alarm_batch_end();
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:%d alarms are deleted in a batch "
+			    "for pid(%d)\n", alarm_id_array->len, pid);
 
 	return true;
 }
@@ -2009,84 +1951,28 @@ gboolean alarm_manager_alarm_get_number_of_ids(void *pObject, int pid,
 					       int *num_of_ids,
 					       int *return_code)
 {
-	GSList *gs_iter = NULL;
 	GQuark quark_app_unique_name;	/* the fullpath of pid(pid) is 
 					   converted  to quark value. */
-	char proc_file[256] = { 0 };
-	char process_name[512] = { 0 };
-	char app_name[256] = { 0 };
-	char *word = NULL;
-	__alarm_info_t *entry = NULL;
-	char *proc_name_ptr = NULL;
 
 	*num_of_ids = 0;
 	*return_code = 0;
 
-	/* we should consider to check whether  pid is running or Not
-	 */
-	memset(process_name, '\0', 512);
-	memset(proc_file, '\0', 256);
-	snprintf(proc_file, 256, "/proc/%d/cmdline", pid);
-
-	int fd;
-	int ret;
-	int i = 0;
-	fd = open(proc_file, O_RDONLY);
-	if (fd > 0) {
-		ret = read(fd, process_name, 512);
-		close(fd);
-		while (process_name[i] != '\0') {
-			if (process_name[i] == ' ') {
-				process_name[i] = '\0';
-				break;
-			}
-			i++;
-		}
-		/*if (readlink(proc_file, process_name, 256)!=-1) */
-		/*success */
-
-		word = strtok_r(process_name, "/", &proc_name_ptr);
-		while (word != NULL) {
-			memset(app_name, 0, 256);
-			snprintf(app_name, 256, "%s", word);
-			word = strtok_r(NULL, "/", &proc_name_ptr);
-		}
-		quark_app_unique_name = g_quark_from_string(app_name);
-	} else {		/* failure */
-
-		quark_app_unique_name = g_quark_from_string("unknown");
-		memcpy(app_name, "unknown", strlen("unknown") + 1);
-
-		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid(%d) seems to be "
-					  "killed, so we failed to get proc file(%s) \n",
-					  pid, proc_file);
+	if (!_alarm_app_name_lookup(pid, &quark_app_unique_name)) {
 		*return_code = -1;	/* -1 means that system 
 					   failed internally. */
 		return true;
 	}
 
 	ALARM_MGR_LOG_PRINT("called for  app(pid:%d, name=%s)\n",
-			    pid, app_name);
-
-	for (gs_iter = alarm_context.alarms; gs_iter != NULL;
-	     gs_iter = g_slist_next(gs_iter)) {
-		entry = gs_iter->data;
-		ALARM_MGR_LOG_PRINT("alarm_manager_alarm_get_number_of_ids(): "
-				    "app_name=%s,quark_app_unique_name=%s\n",
-		app_name, g_quark_to_string(entry->quark_app_unique_name));
-		if (strcmp
-		    (app_name,
-		     g_quark_to_string(entry->quark_app_unique_name)) == 0
-		    && strcmp(app_name, "unknown") != 0) {
-			(*num_of_ids)++;
-			ALARM_MGR_LOG_PRINT("inc number of alarms of app "
-					    "(pid:%d, name:%s) is %d\n",
-					    pid, app_name, *num_of_ids);
-		}
-	}
+			    pid, g_quark_to_string(quark_app_unique_name));
+
+	if (quark_app_unique_name != g_quark_from_string("unknown"))
+		*num_of_ids = _alarm_table_app_size(quark_app_unique_name);
+
 	*return_code = 0;
 	ALARM_MGR_LOG_PRINT("number of alarms of app(pid:%d, name:%s) is %d\n",
-			    pid, app_name, *num_of_ids);
+			    pid, g_quark_to_string(quark_app_unique_name),
+			    *num_of_ids);
 	return true;
 }
 
@@ -2095,19 +1981,11 @@ gboolean alarm_manager_alarm_get_list_of_ids(void *pObject, int pid,
 					     GArray **arr, int *num_of_ids,
 					     int *return_code)
 {
-	GSList *gs_iter = NULL;
+	GList *iter = NULL;
 	GQuark quark_app_unique_name;	/* the fullpath of pid(pid) is converted
 					   to quark value. */
-	char proc_file[256] = { 0 };
-	char process_name[512] = { 0 };
-	char app_name[256] = { 0 };
-	char *word = NULL;
 	__alarm_info_t *entry = NULL;
 	int index = 0;
-	char *proc_name_ptr = NULL;
-	int fd;
-	int ret;
-	int i = 0;
 	GArray *garray = NULL;
 
 	*return_code = 0;
@@ -2125,57 +2003,24 @@ gboolean alarm_manager_alarm_get_list_of_ids(void *pObject, int pid,
 		return true;
 	}
 
-	/* we should consider to check whether  pid is running or Not
-	 */
-	memset(process_name, '\0', 512);
-	memset(proc_file, '\0', 256);
-	snprintf(proc_file, 256, "/proc/%d/cmdline", pid);
-
-	fd = open(proc_file, O_RDONLY);
-	if (fd > 0) {
-		ret = read(fd, process_name, 512);
-		close(fd);
-		while (process_name[i] != '\0') {
-			if (process_name[i] == ' ') {
-				process_name[i] = '\0';
-				break;
-			}
-			i++;
-		}
-		/* if (readlink(proc_file, process_name, 256)!=-1) */
-		/*success */
-
-		word = strtok_r(process_name, "/", &proc_name_ptr);
-		while (word != NULL) {
-			memset(app_name, 0, 256);
-			snprintf(app_name, 256, "%s", word);
-			word = strtok_r(NULL, "/", &proc_name_ptr);
-		}
-		quark_app_unique_name = g_quark_from_string(app_name);
-	} else {		/* failure */
-
-		quark_app_unique_name = g_quark_from_string("unknown");
-		memcpy(app_name, "unknown", strlen("unknown") + 1);
-
-		ALARM_MGR_EXCEPTION_PRINT("Caution!! app_pid(%d) seems to be "
-		"killed, so we failed to get proc file(%s)\n", pid, proc_file);
+	if (!_alarm_app_name_lookup(pid, &quark_app_unique_name)) {
+		*arr = garray;
 		*return_code = -1;
 		/* -1 means that system failed internally. */
 		return true;
 	}
 
 	ALARM_MGR_LOG_PRINT("called for  app(pid:%d, name=%s)\n",
-			    pid, app_name);
-
-	for (gs_iter = alarm_context.alarms; gs_iter != NULL;
-	     gs_iter = g_slist_next(gs_iter)) {
-		entry = gs_iter->data;
-		if (strcmp
-		    (app_name,
-		     g_quark_to_string(entry->quark_app_unique_name)) == 0
-		    && strcmp(app_name, "unknown") != 0) {
-			g_array_append_val(garray, entry->alarm_id);
-		}
+			    pid, g_quark_to_string(quark_app_unique_name));
+
+	if (quark_app_unique_name == g_quark_from_string("unknown"))
+		iter = NULL;
+	else
+		iter = _alarm_table_app_alarms(quark_app_unique_name);
+
+	for (; iter != NULL; iter = g_list_next(iter)) {
+		entry = iter->data;
+		g_array_append_val(garray, entry->alarm_id);
 	}
 
 	*num_of_ids = index;
@@ -2185,62 +2030,111 @@ gboolean alarm_manager_alarm_get_list_of_ids(void *pObject, int pid,
 	return true;
 }
 
-gboolean alarm_manager_alarm_get_appsvc_info(void *pObject, int pid, alarm_id_t alarm_id,
-				char *e_cookie, gchar **b_data, int *return_code)
+/*
+ * Returns a page of the alarms of the application, which are ordered by
+ * alarm_id (signed) : at most page_size alarms from the first one if
+ * first_page is true, or whose id is greater than cursor otherwise.
+ * Ids of alarms saved by older versions may be negative, so no cursor value
+ * can stand for the first page. alarm_infos has ALARM_INFO_PACKED_LEN ints
+ * per alarm, and next_cursor is the cursor of the next page, 0 if there is
+ * no alarm left (0 is never an alarm id).
+ */
+gboolean alarm_manager_alarm_get_alarms(void *pObject, int pid,
+					gboolean first_page, int cursor,
+					int page_size, GArray **alarm_ids,
+					GArray **alarm_infos, int *next_cursor,
+					int *return_code)
 {
-	bool found = false;
-
-	GSList *gs_iter = NULL;
+	GQuark quark_app_unique_name;
+	GList *iter = NULL;
 	__alarm_info_t *entry = NULL;
+	alarm_info_t *alarm_info = NULL;
+	int packed[ALARM_INFO_PACKED_LEN];
+	int i;
 
-	guchar *cookie = NULL;
-	gsize size;
-	int retval = 0;
-	gid_t call_gid;
+	*return_code = 0;
+	*next_cursor = 0;
+	*alarm_ids = g_array_new(false, true, sizeof(alarm_id_t));
+	*alarm_infos = g_array_new(false, true, sizeof(int));
 
-	ALARM_MGR_LOG_PRINT("called for  pid(%d) and alarm_id(%d)\n", pid,
-			    alarm_id);
+	if (page_size <= 0 || page_size > ALARM_BATCH_MAX) {
+		*return_code = ERR_ALARM_INVALID_PARAM;
+		return true;
+	}
 
-	cookie = g_base64_decode(e_cookie, &size);
-	if (NULL == cookie)
-	{
-		if (return_code)
-			*return_code = ERR_ALARM_SYSTEM_FAIL;
-		ALARM_MGR_EXCEPTION_PRINT("Unable to decode cookie!!!\n");
+	if (!_alarm_app_name_lookup(pid, &quark_app_unique_name)) {
+		*return_code = -1;	/* -1 means that system
+					   failed internally. */
 		return true;
 	}
-	call_gid = security_server_get_gid("alarm");
 
-	ALARM_MGR_LOG_PRINT("call_gid : %d\n", call_gid);
+	if (quark_app_unique_name == g_quark_from_string("unknown"))
+		return true;
 
-	retval = security_server_check_privilege((const char *)cookie, call_gid);
-	if (retval < 0) {
-		if (retval == SECURITY_SERVER_API_ERROR_ACCESS_DENIED) {
-			ALARM_MGR_EXCEPTION_PRINT(
-				"%s", "access has been denied\n");
-		}
-		ALARM_MGR_EXCEPTION_PRINT("%s", "Error has occurred\n");
+	if (first_page)
+		iter = _alarm_table_app_alarms(quark_app_unique_name);
+	else
+		iter = _alarm_table_app_alarms_after(quark_app_unique_name,
+						     cursor);
+
+	for (i = 0; iter != NULL && i < page_size;
+	     i++, iter = g_list_next(iter)) {
+		entry = iter->data;
+		alarm_info = &entry->alarm_info;
+
+		packed[0] = alarm_info->start.year;
+		packed[1] = alarm_info->start.month;
+		packed[2] = alarm_info->start.day;
+		packed[3] = alarm_info->start.hour;
+		packed[4] = alarm_info->start.min;
+		packed[5] = alarm_info->start.sec;
+		packed[6] = alarm_info->end.year;
+		packed[7] = alarm_info->end.month;
+		packed[8] = alarm_info->end.day;
+		packed[9] = alarm_info->mode.u_interval.day_of_week;
+		packed[10] = alarm_info->mode.repeat;
+		packed[11] = alarm_info->alarm_type;
+		packed[12] = alarm_info->reserved_info;
+
+		g_array_append_val(*alarm_ids, entry->alarm_id);
+		g_array_append_vals(*alarm_infos, packed,
+				    ALARM_INFO_PACKED_LEN);
+	}
+
+	if (iter != NULL)
+		*next_cursor = entry->alarm_id;
+
+	ALARM_MGR_LOG_PRINT("[alarm-server]:%d alarms after id(%d) are "
+			    "returned to app(pid:%d)\n", i,
+			    first_page ? 0 : cursor, pid);
+
+	return true;
+}
+
+gboolean alarm_manager_alarm_get_appsvc_info(void *pObject, int pid, alarm_id_t alarm_id,
+				char *e_cookie, gchar **b_data, int *return_code)
+{
+	bool found = false;
 
+	__alarm_info_t *entry = NULL;
+
+	ALARM_MGR_LOG_PRINT("called for  pid(%d) and alarm_id(%d)\n", pid,
+			    alarm_id);
+
+	if (!_alarm_privilege_check(e_cookie)) {
 		if (return_code)
 			*return_code = ERR_ALARM_NO_PERMISSION;
 
-		if (cookie)
-			g_free(cookie);
-
 		return true;
 	}
 
 	if (return_code)
 		*return_code = 0;
 
-	for (gs_iter = alarm_context.alarms; gs_iter != NULL;
-	     gs_iter = g_slist_next(gs_iter)) {
-		entry = gs_iter->data;
-		if (entry->alarm_id == alarm_id) {
-			found = true;
-			*b_data = g_strdup(g_quark_to_string(entry->quark_bundle));
-			break;
-		}
+	entry = _alarm_table_find(alarm_id);
+	if (entry != NULL) {
+		found = true;
+		*b_data = g_strdup(_alarm_bundle_data(entry->bundle));
 	}
 
 	if (found) {
@@ -2254,9 +2148,6 @@ gboolean alarm_manager_alarm_get_appsvc_info(void *pObject, int pid, alarm_id_t
 			*return_code = ERR_ALARM_INVALID_ID;
 	}
 
-	if (cookie)
-		g_free(cookie);
-
 	return true;
 }
 
@@ -2273,19 +2164,14 @@ gboolean alarm_manager_alarm_get_info(void *pObject, int pid,
 	ALARM_MGR_LOG_PRINT("called for  pid(%d) and alarm_id(%d)\n", pid,
 			    alarm_id);
 
-	GSList *gs_iter = NULL;
 	__alarm_info_t *entry = NULL;
 
 	alarm_info_t *alarm_info = NULL;
 	*return_code = 0;
 
-	for (gs_iter = alarm_context.alarms; gs_iter != NULL;
-	     gs_iter = g_slist_next(gs_iter)) {
-		entry = gs_iter->data;
-		if (entry->alarm_id == alarm_id) {
-			alarm_info = &(entry->alarm_info);
-			break;
-		}
+	entry = _alarm_table_find(alarm_id);
+	if (entry != NULL) {
+		alarm_info = &(entry->alarm_info);
 	}
 
 	if (alarm_info == NULL)
@@ -2317,6 +2203,46 @@ gboolean alarm_manager_alarm_get_info(void *pObject, int pid,
 	return true;
 }
 
+/*
+ * debug method : returns the allocator and cache statistics of the server
+ * as text, one "name key=value ..." line per item.
+ */
+gboolean alarm_manager_alarm_get_stats(void *pObject, int pid, char *e_cookie,
+				       gchar **stats, int *return_code)
+{
+	GString *out = NULL;
+	guint count = 0;
+	gsize bytes = 0;
+	guint hit = 0;
+	guint miss = 0;
+
+	*stats = NULL;
+
+	if (!_alarm_privilege_check(e_cookie)) {
+		*return_code = ERR_ALARM_NO_PERMISSION;
+		return true;
+	}
+
+	out = g_string_new(NULL);
+
+	g_string_append_printf(out, "alarms count=%u\n", _alarm_table_size());
+	_alarm_pool_dump(out);
+
+	_alarm_bundle_get_stats(&count, &bytes);
+	g_string_append_printf(out, "bundle count=%u bytes=%lu\n", count,
+			       (gulong)bytes);
+
+	_alarm_app_name_get_stats(&hit, &miss);
+	g_string_append_printf(out, "app_name hit=%u miss=%u\n", hit, miss);
+
+	*stats = g_string_free(out, FALSE);
+	*return_code = 0;
+
+	ALARM_MGR_LOG_PRINT("stats requested by pid(%d)\n", pid);
+
+	return true;
+}
+
 #include "alarm-skeleton.h"
 
 typedef struct AlarmManagerObject AlarmManagerObject;
@@ -2368,9 +2294,12 @@ static void __initialize_timer()
 static void __initialize_alarm_list()
 {
 
-	alarm_context.alarms = NULL;
+	_alarm_queue_init(getenv(ALARM_SCHEDULER_ENV));
+	_alarm_table_init();
 	alarm_context.c_due_time = -1;
 
+	_alarm_id_init();
+	_alarm_boot_init(getenv(ALARM_BOOT_ENV), __rtc_set);
 	_load_alarms_from_registry();
 
 	__rtc_set();	/*Set RTC1 Alarm with alarm due time for alarm-manager initialization*/
@@ -2399,6 +2328,9 @@ static void __hibernation_leave_callback()
 
 	__initialize_scheduled_alarm_lsit();
 
+	/* pending mutations are lost otherwise, since the alarms are reloaded
+	   from the registry */
+	_registry_flush();
 	__alarm_clean_list();
 
 	__initialize_alarm_list();
@@ -2434,9 +2366,9 @@ static DBusHandlerResult __alarm_server_filter(DBusConnection *connection,
 
 	if (dbus_message_is_signal
 	    (message, DBUS_INTERFACE_DBUS, "NameOwnerChanged")) {
-		char *service;
-		char *old_owner;
-		char *new_owner;
+		char *service = NULL;
+		char *old_owner = NULL;
+		char *new_owner = NULL;
 		GSList *entry;
 		__expired_alarm_t *expire_info;
 
@@ -2447,6 +2379,14 @@ static DBusHandlerResult __alarm_server_filter(DBusConnection *connection,
 				      DBUS_TYPE_STRING, &new_owner,
 				      DBUS_TYPE_INVALID);
 
+		_alarm_name_owner_changed(service, new_owner);
+
+		/* a client has left the bus, and its pid may be reused */
+		if (service != NULL && service[0] == ':'
+		    && (new_owner == NULL || new_owner[0] == '\0'))
+			_alarm_app_name_invalidate();
+
+		G_LOCK(expired_alarm_list);
 		for (entry = g_expired_alarm_list; entry; entry = entry->next) {
 			if (entry->data) {
 				expire_info = (__expired_alarm_t *) entry->data;
@@ -2469,6 +2409,7 @@ static DBusHandlerResult __alarm_server_filter(DBusConnection *connection,
 				}
 			}
 		}
+		G_UNLOCK(expired_alarm_list);
 
 		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
 	}
@@ -2533,38 +2474,19 @@ static bool __initialize_dbus()
 		return false;
 	}
 
+	/* the names owned from now on are tracked by the filter */
+	_alarm_name_owner_init(dbus_g_connection_get_connection(connection));
+
 	alarm_context.bus = connection;
 	return true;
 }
 
 #define ALARMMGR_DB_FILE "/opt/dbspace/.alarmmgr.db"
 sqlite3 *alarmmgr_db;
-#define QUERY_CREATE_TABLE_ALARMMGR "create table alarmmgr \
-				(alarm_id integer primary key,\
-						start integer,\
-						end integer,\
-						pid integer,\
-						app_unique_name text,\
-						app_service_name text,\
-						app_service_name_mod text,\
-						bundle text, \
-						year integer,\
-						month integer,\
-						day integer,\
-						hour integer,\
-						min integer,\
-						sec integer,\
-						day_of_week integer,\
-						repeat integer,\
-						alarm_type integer,\
-						reserved_info integer,\
-						dst_service_name text, \
-						dst_service_name_mod text \
-						)"
-
 static bool __initialize_db()
 {
 	char *error_message = NULL;
+	char *window = NULL;
 	int ret;
 
 	if (access("/opt/dbspace/.alarmmgr.db", F_OK) == 0) {
@@ -2579,7 +2501,7 @@ static bool __initialize_db()
 			return false;
 		}
 
-		return true;
+		goto setup;
 	}
 
 	ret =
@@ -2602,7 +2524,34 @@ static bool __initialize_db()
 		return false;
 	}
 
-	return true;
+ setup:
+	/* the storage profile and the meta table are applied to the registries
+	   of older versions too */
+	_registry_set_profile(getenv(ALARM_REGISTRY_PROFILE_ENV));
+
+
+	if (SQLITE_OK !=
+	    sqlite3_exec(alarmmgr_db, QUERY_CREATE_TABLE_ALARMMGR_META, NULL,
+			 NULL, &error_message)) {
+		ALARM_MGR_EXCEPTION_PRINT("Don't execute query = %s, "
+		"error message = %s\n", QUERY_CREATE_TABLE_ALARMMGR_META,
+					  error_message);
+		return false;
+	}
+
+	window = getenv(ALARM_REGISTRY_WINDOW_ENV);
+
+	return _registry_init(window ? atoi(window) : 0);
+}
+
+static void __initialize_dispatch()
+{
+	char *threaded = NULL;
+
+	threaded = getenv(ALARM_DISPATCH_THREAD_ENV);
+
+	_alarm_dispatch_init(threaded ? atoi(threaded) != 0 : true,
+			     __alarm_deliver);
 }
 
 static void __initialize()
@@ -2658,6 +2607,7 @@ static void __initialize()
 					  "alarm-server cannot be runned.\n");
 		exit(1);
 	}
+	__initialize_dispatch();
 	__initialize_scheduled_alarm_lsit();
 	__initialize_db();
 	__initialize_alarm_list();
@@ -2695,12 +2645,27 @@ static bool __check_false_alarm()
 }
 #endif
 
+static gboolean __alarm_server_terminate(gpointer user_data)
+{
+	ALARM_MGR_LOG_PRINT("[alarm-server]: terminated\n");
+	g_main_loop_quit((GMainLoop *)user_data);
+
+	return FALSE;
+}
+
 int main()
 {
 	GMainLoop *mainloop = NULL;
 
 	ALARM_MGR_LOG_PRINT("Enter main loop\n");
 
+	/* expired alarms are delivered from the threads of the dispatch
+	   pipeline */
+#if !GLIB_CHECK_VERSION (2, 31, 0)
+	g_thread_init(NULL);
+#endif
+	dbus_g_thread_init();
+
 	mainloop = g_main_loop_new(NULL, FALSE);
 
 	__initialize();
@@ -2711,7 +2676,16 @@ int main()
 	}
 #endif
 
+	g_unix_signal_add(SIGTERM, __alarm_server_terminate, mainloop);
+
 	g_main_loop_run(mainloop);
 
+	/* deliver the expired alarms and write the pending mutations before
+	   exiting */
+	_alarm_dispatch_shutdown();
+	dbus_connection_flush(dbus_g_connection_get_connection
+			      (alarm_context.bus));
+	_registry_flush();
+
 	return 0;
 }
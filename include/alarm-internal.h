@@ -33,6 +33,7 @@
 #define ALARM_INFO_MAX 100
 
 #include "alarm.h"
+#include <dbus/dbus.h>
 #include <dbus/dbus-glib.h>
 #include <glib.h>
 #include <dlog.h>
@@ -47,6 +48,26 @@
 
 #define SYSTEM_TIME_CHANGED "setting_time_changed"
 
+/* batch requests : an alarm_info_t is sent as ALARM_INFO_PACKED_LEN ints
+   (start y/m/d/h/m/s, end y/m/d, day_of_week, repeat, alarm_type,
+   reserved_info), and at most ALARM_BATCH_MAX alarms are sent at once */
+#define ALARM_INFO_PACKED_LEN 13
+#define ALARM_BATCH_MAX 256
+
+/* environment variable selecting the scheduler backend : "heap" or "wheel" */
+#define ALARM_SCHEDULER_ENV "ALARM_MGR_SCHEDULER"
+/* environment variable setting the registry write-behind window in msec */
+#define ALARM_REGISTRY_WINDOW_ENV "ALARM_MGR_REGISTRY_WINDOW_MS"
+/* environment variable selecting the registry storage profile :
+   "wal-full"(default), "wal" or "rollback" */
+#define ALARM_REGISTRY_PROFILE_ENV "ALARM_MGR_REGISTRY_PROFILE"
+/* environment variable selecting how due times are computed at startup :
+   "eager"(default) or "lazy" */
+#define ALARM_BOOT_ENV "ALARM_MGR_BOOT"
+/* environment variable selecting where expired alarms are delivered :
+   "1"(default) on a dispatch thread, "0" on the main loop */
+#define ALARM_DISPATCH_THREAD_ENV "ALARM_MGR_DISPATCH_THREAD"
+
 #ifdef LOG_TAG
 #undef LOG_TAG
 #endif
@@ -126,6 +147,24 @@ bool _send_alarm_update(alarm_context_t context, int pid, alarm_id_t alarm_id,
 			 alarm_info_t *alarm_info, int *error_code);
 bool _send_alarm_delete(alarm_context_t context, alarm_id_t alarm_id,
 			 int *error_code);
+bool _send_alarm_create_batch(alarm_context_t context, alarm_info_t **alarms,
+			int count, const char *dst_service_name,
+			const char *dst_service_name_mod, alarm_id_t *alarm_ids,
+			int *results, int *error_code);
+bool _send_alarm_delete_batch(alarm_context_t context,
+			const alarm_id_t *alarm_ids, int count, int *results,
+			int *error_code);
+bool _send_alarm_create_async(alarm_context_t context, alarm_info_t *alarm_info,
+			const char *dst_service_name,
+			const char *dst_service_name_mod,
+			alarm_result_cb_t callback, void *user_param,
+			int *error_code);
+bool _send_alarm_delete_async(alarm_context_t context, alarm_id_t alarm_id,
+			alarm_result_cb_t callback, void *user_param,
+			int *error_code);
+bool _send_alarm_get_info_async(alarm_context_t context, alarm_id_t alarm_id,
+			alarm_info_cb_t callback, void *user_param,
+			int *error_code);
 bool _send_alarm_get_list_of_ids(alarm_context_t context, int maxnum_of_ids,
 				  alarm_id_t *alarm_id, int *num_of_ids,
 				  int *error_code);
@@ -133,6 +172,10 @@ bool _send_alarm_get_number_of_ids(alarm_context_t context, int *num_of_ids,
 				    int *error_code);
 bool _send_alarm_get_info(alarm_context_t context, alarm_id_t alarm_id,
 			   alarm_info_t *alarm_info, int *error_code);
+bool _send_alarm_get_alarms(alarm_context_t context, bool first_page,
+			    int cursor, int page_size, alarm_id_t *alarm_ids,
+			    alarm_info_t *alarm_infos, int *num_of_alarms,
+			    int *next_cursor, int *error_code);
 bool _send_alarm_reset(alarm_context_t context, int *error_code);
 
 bool _send_alarm_power_on(alarm_context_t context, bool on_off,
@@ -146,11 +189,25 @@ bundle *_send_alarm_get_appsvc_info(alarm_context_t context, alarm_id_t alarm_id
 bool _send_alarm_set_rtc_time(alarm_context_t context, alarm_date_t *time, int *error_code);
 
 /*  alarm manager*/
+
+/* shared payload of the encoded bundles, see alarm-manager-bundle.c */
+typedef struct __alarm_bundle_t __alarm_bundle_t;
+
+/* the fields read by the scheduler come first, so that they share the
+   first cache lines of the record, and the names and the bundle, which are
+   read when the alarm is created or delivered, come after them */
 typedef struct {
+	time_t due_time;
 	time_t start;
 	time_t end;
 
 	int alarm_id;
+	int queue_idx;	/*position in the due-time queue(heap index or wheel
+			  slot), -1 if not queued*/
+	GList *queue_link;	/*node of the wheel slot, NULL if not queued*/
+
+	alarm_info_t alarm_info;
+
 	int pid;
 	GQuark quark_app_unique_name;	/*the fullpath of application's pid is
 		converted to quark value.*/
@@ -162,11 +219,11 @@ typedef struct {
 		quark value.app_service_name is a service name  for 
 		dst_service_name of alarm_create_extend().*/
 	GQuark quark_dst_service_name_mod;
-	time_t due_time;
 
-	GQuark quark_bundle;	/*Bundle Content containing app-svc info*/
+	__alarm_bundle_t *bundle;	/*Bundle Content containing app-svc info,
+					  NULL if it is not an app-svc alarm*/
 
-	alarm_info_t alarm_info;
+	GList *app_link;	/*node of the application's alarm list*/
 
 } __alarm_info_t;
 
@@ -175,10 +232,21 @@ typedef struct {
 	__alarm_info_t *__alarm_info;
 } __alarm_entry_t;
 
+/* alarm table : all alarms registered in the server, indexed by alarm_id
+   and by quark_app_unique_name */
+typedef struct {
+	GHashTable *by_id;
+	GHashTable *by_app;	/*quark_app_unique_name -> GQueue of alarms*/
+} __alarm_table_t;
+
+typedef struct {
+	GHashTableIter iter;
+} __alarm_table_iter_t;
+
 typedef struct {
 	timer_t timer;
 	time_t c_due_time;
-	GSList *alarms;
+	__alarm_table_t alarms;
 	int gmt_idx;
 	int dst;
 	DBusGConnection *bus;
@@ -196,14 +264,155 @@ typedef struct {
 	alarm_id_t alarm_id;
 } __expired_alarm_t;
 
+/* longest window of an inexact alarm in seconds */
+#define ALARM_WINDOW_MAX (60 * 60)
+
 time_t _alarm_next_duetime(__alarm_info_t *alarm_info);
+time_t _alarm_deadline(__alarm_info_t *__alarm_info);
 bool _alarm_schedule();
 bool _clear_scheduled_alarm_list();
 bool _add_to_scheduled_alarm_list(__alarm_info_t *__alarm_info);
 
+bool _alarm_boot_init(const char *mode, void (*rescheduled)(void));
+void _alarm_boot_duetime(__alarm_info_t *__alarm_info, time_t saved_due_time);
+bool _alarm_boot_schedule();
+
+typedef void (*__alarm_queue_cb_t)(__alarm_info_t *__alarm_info, void *data);
+
+/* due-time queue backend */
+typedef struct {
+	const char *name;
+	bool (*init)(void);
+	void (*clear)(void);
+	bool (*update)(__alarm_info_t *__alarm_info);
+	void (*remove)(__alarm_info_t *__alarm_info);
+	__alarm_info_t *(*first)(time_t current_time);
+	void (*foreach_due)(time_t due_time, __alarm_queue_cb_t func,
+			    void *data);
+	bool (*rebuild)(void);
+} __alarm_queue_ops_t;
+
+extern __alarm_queue_ops_t _alarm_heap_queue_ops;
+extern __alarm_queue_ops_t _alarm_wheel_queue_ops;
+
+bool _alarm_queue_init(const char *backend);
+void _alarm_queue_clear();
+bool _alarm_queue_update(__alarm_info_t *__alarm_info);
+void _alarm_queue_remove(__alarm_info_t *__alarm_info);
+__alarm_info_t *_alarm_queue_first(time_t current_time);
+void _alarm_queue_foreach_due(time_t due_time, __alarm_queue_cb_t func,
+			      void *data);
+bool _alarm_queue_rebuild();
+
+typedef struct __alarm_pool_t __alarm_pool_t;
+
+__alarm_pool_t *_alarm_pool_new(const char *name, gsize object_size,
+				guint objects_per_slab);
+gpointer _alarm_pool_alloc0(__alarm_pool_t *pool);
+void _alarm_pool_free(__alarm_pool_t *pool, gpointer data);
+void _alarm_pool_dump(GString *out);
+
+__alarm_info_t *_alarm_info_new();
+void _alarm_info_free(__alarm_info_t *__alarm_info);
+bool _alarm_table_init();
+void _alarm_table_clear();
+bool _alarm_table_add(__alarm_info_t *__alarm_info);
+bool _alarm_table_load(__alarm_info_t *__alarm_info);
+__alarm_info_t *_alarm_table_find(alarm_id_t alarm_id);
+bool _alarm_table_remove(alarm_id_t alarm_id);
+guint _alarm_table_size();
+guint _alarm_table_app_size(GQuark quark_app_unique_name);
+GList *_alarm_table_app_alarms(GQuark quark_app_unique_name);
+GList *_alarm_table_app_alarms_after(GQuark quark_app_unique_name,
+				     alarm_id_t after_id);
+void _alarm_table_iter_init(__alarm_table_iter_t *iter);
+bool _alarm_table_iter_next(__alarm_table_iter_t *iter,
+			    __alarm_info_t **__alarm_info);
+
+bool _alarm_id_init();
+void _alarm_id_mark_used(alarm_id_t alarm_id);
+alarm_id_t _alarm_id_alloc();
+void _alarm_id_free(alarm_id_t alarm_id);
+
+bool _alarm_privilege_check(const char *e_cookie);
+
+__alarm_bundle_t *_alarm_bundle_get(const char *data);
+__alarm_bundle_t *_alarm_bundle_ref(__alarm_bundle_t *bundle);
+void _alarm_bundle_unref(__alarm_bundle_t *bundle);
+const char *_alarm_bundle_data(__alarm_bundle_t *bundle);
+bundle *_alarm_bundle_dup_decoded(__alarm_bundle_t *payload);
+void _alarm_bundle_get_stats(guint *count, gsize *bytes);
+
+bool _alarm_app_name_lookup(int pid, GQuark *quark_app_unique_name);
+void _alarm_app_name_invalidate();
+void _alarm_app_name_get_stats(guint *hit, guint *miss);
+
+/* an expired alarm queued to be delivered. The fields of the alarm needed
+   to deliver it are copied, because the alarm may be rescheduled or removed
+   while it is being delivered. */
+typedef struct {
+	alarm_id_t alarm_id;
+	int pid;
+	GQuark quark_app_service_name;
+	GQuark quark_app_service_name_mod;
+	GQuark quark_dst_service_name;
+	GQuark quark_dst_service_name_mod;
+	__alarm_bundle_t *bundle;	/*a reference is held until delivered*/
+	time_t due_time;
+	gint64 queued_usec;
+} __alarm_delivery_t;
+
+typedef void (*__alarm_deliver_func_t)(__alarm_delivery_t *delivery);
+
+bool _alarm_dispatch_init(bool threaded, __alarm_deliver_func_t deliver);
+void _alarm_dispatch_push(__alarm_info_t *__alarm_info, time_t due_time);
+void _alarm_dispatch_flush();
+void _alarm_dispatch_barrier(GSourceFunc done, gpointer data);
+void _alarm_dispatch_shutdown();
+void _alarm_dispatch_log_stats();
+
+bool _alarm_name_owner_init(DBusConnection *connection);
+void _alarm_name_owner_changed(const char *name, const char *new_owner);
+bool _alarm_name_has_owner(const char *name);
+
+/* schema of the registry database */
+#define QUERY_CREATE_TABLE_ALARMMGR "create table alarmmgr \
+				(alarm_id integer primary key,\
+						start integer,\
+						end integer,\
+						pid integer,\
+						app_unique_name text,\
+						app_service_name text,\
+						app_service_name_mod text,\
+						bundle text, \
+						year integer,\
+						month integer,\
+						day integer,\
+						hour integer,\
+						min integer,\
+						sec integer,\
+						day_of_week integer,\
+						repeat integer,\
+						alarm_type integer,\
+						reserved_info integer,\
+						dst_service_name text, \
+						dst_service_name_mod text, \
+						due_time integer default 0 \
+						)"
+
+#define QUERY_CREATE_TABLE_ALARMMGR_META "create table if not exists \
+				alarmmgr_meta (key text primary key, \
+						value integer)"
+
 bool _save_alarms(__alarm_info_t *__alarm_info);
 bool _delete_alarms(alarm_id_t alarm_id);
 bool _update_alarms(__alarm_info_t *__alarm_info);
+bool _load_alarm_id_ceiling(alarm_id_t *ceiling);
+bool _save_alarm_id_ceiling(alarm_id_t ceiling);
+bool _registry_set_profile(const char *profile);
+bool _registry_init(guint flush_window);
+bool _registry_flush();
+void _registry_log_stats();
 
 timer_t _alarm_create_timer();
 bool _alarm_destory_timer(timer_t timer);
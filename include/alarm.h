@@ -217,6 +217,7 @@ typedef enum {
 
 #define ALARM_TYPE_DEFAULT	0x0	/*< non volatile */
 #define ALARM_TYPE_VOLATILE	0x02	/*< volatile */
+#define ALARM_TYPE_INEXACT	0x04	/*< may be delayed within its window */
 
 
 /**
@@ -234,6 +235,27 @@ typedef struct {
 
 typedef struct alarm_info_t alarm_entry_t;
 
+/**
+* The iterator of alarmmgr_enum_alarms_begin()
+*/
+typedef struct alarm_enum_t alarm_enum_t;
+
+/**
+* The prototype of the callback of an asynchronous request.
+* param [in]	alarm_id	the id of the alarm, -1 if the alarm is not added
+* param [in]	result		ALARMMGR_RESULT_SUCCESS or a negative error code
+*/
+typedef void (*alarm_result_cb_t) (alarm_id_t alarm_id, int result,
+				   void *user_param);
+
+/**
+* The prototype of the callback of alarmmgr_get_info_async().
+* alarm is valid only in the callback, and it is NULL on failure.
+*/
+typedef void (*alarm_info_cb_t) (alarm_id_t alarm_id,
+				 const alarm_entry_t *alarm, int result,
+				 void *user_param);
+
 
 /**
  *
@@ -1063,6 +1085,34 @@ int alarmmgr_add_alarm(int alarm_type, time_t trigger_at_time,
 			       time_t interval, const char *destination,
 			       alarm_id_t *alarm_id);
 
+/**
+ * This function adds an inexact alarm entry to the server.
+ * It works like alarmmgr_add_alarm(), but the alarm may be expired at any time
+ * from trigger_at_time seconds from now until window seconds later. The server
+ * expires the alarms whose windows overlap at once, so that the device wakes
+ * up fewer times. The alarm type of the new alarm is alarm_type with
+ * ALARM_TYPE_INEXACT set.
+ *
+ * @param	[in]		alarm_type		one of ALARM_TYPE_DEFAULT, ALARM_TYPE_VOLATILE
+ * @param	[in]		trigger_at_time	time interval to be triggered from now(sec). the alarm is not expired before triggering time.
+ * @param	[in]		window			how long the alarm may be delayed after triggering time(sec). it must be positive, and a window longer than an hour is shortened to an hour.
+ * @param	[in]		interval			Interval between subsequent repeats of the alarm
+ * @param	[in]		destination		the packname of application that the alarm will be expired.
+ * @param	[out] 	alarm_id			the id of the alarm added.
+ *
+ * @return	This function returns ALARMMGR_RESULT_SUCCESS on success or a negative number on failure.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_add_alarm alarmmgr_remove_alarm
+ * @remark  Every repeat of the alarm may be delayed within the window.
+ * @limo
+ */
+int alarmmgr_add_alarm_with_window(int alarm_type, time_t trigger_at_time,
+				   time_t window, time_t interval,
+				   const char *destination,
+				   alarm_id_t *alarm_id);
+
 /**
  * This function deletes the alarm associated with the given alarm_id.
  *
@@ -1115,6 +1165,128 @@ int alarmmgr_add_alarm(int alarm_type, time_t trigger_at_time,
  */
 int alarmmgr_remove_alarm(alarm_id_t alarm_id);
 
+/**
+ * This function is the asynchronous version of alarmmgr_add_alarm().
+ * It returns as soon as the request is sent, and callback is called from the
+ * main loop with the id of the new alarm when the server replies.
+ * Requests may be pipelined: callbacks are called in the order of replies.
+ *
+ * @param	[in]		alarm_type		one of ALARM_TYPE_DEFAULT, ALARM_TYPE_VOLATILE
+ * @param	[in]		trigger_at_time	time interval to be triggered from now(sec). an alarm also will be expired at triggering time.
+ * @param	[in]		interval			Interval between subsequent repeats of the alarm
+ * @param	[in]		destination		the packname of application that the alarm will be expired.
+ * @param	[in]		callback		the function called with the result
+ * @param	[in]		user_param		user parameter passed to callback
+ *
+ * @return	This function returns ALARMMGR_RESULT_SUCCESS when the request is sent or a negative number on failure.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_add_alarm alarmmgr_remove_alarm_async
+ * @remark  callback is not called if this function fails.
+ * @limo
+ */
+int alarmmgr_add_alarm_async(int alarm_type, time_t trigger_at_time,
+			     time_t interval, const char *destination,
+			     alarm_result_cb_t callback, void *user_param);
+
+/**
+ * This function is the asynchronous version of alarmmgr_remove_alarm().
+ *
+ * @param	[in]	alarm_id	Specifies the ID of the alarm to be deleted.
+ * @param	[in]	callback	the function called with the result, or NULL
+ * @param	[in]	user_param	user parameter passed to callback
+ *
+ * @return	This function returns ALARMMGR_RESULT_SUCCESS when the request is sent or a negative number on failure.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_remove_alarm alarmmgr_add_alarm_async
+ * @remark  callback is not called if this function fails.
+ * @limo
+ */
+int alarmmgr_remove_alarm_async(alarm_id_t alarm_id,
+				alarm_result_cb_t callback, void *user_param);
+
+/**
+ * This function is the asynchronous version of alarmmgr_get_info().
+ *
+ * @param	[in]	alarm_id	Specifies the ID of the alarm.
+ * @param	[in]	callback	the function called with the alarm entry
+ * @param	[in]	user_param	user parameter passed to callback
+ *
+ * @return	This function returns ALARMMGR_RESULT_SUCCESS when the request is sent or a negative number on failure.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_get_info
+ * @remark  callback is not called if this function fails.
+ * @limo
+ */
+int alarmmgr_get_info_async(alarm_id_t alarm_id, alarm_info_cb_t callback,
+			    void *user_param);
+
+/**
+ * This function adds alarm entries to the server with one request.
+ * Each entry is added as alarmmgr_add_alarm_with_localtime() adds it, but the
+ * alarms are checked, saved and scheduled once for the whole request.
+ *
+ * @param	[in]		alarms		array of the alarm entries to be added
+ * @param	[in]		count		the number of entries in alarms (1 to 256)
+ * @param	[in]		destination	the packname of application that the alarms will be expired.
+ * @param	[out]		alarm_ids	array of count ids. the id is -1 for an alarm which is not added.
+ * @param	[out]		results		array of count error codes, or NULL
+ *
+ * @return	This function returns ALARMMGR_RESULT_SUCCESS when every alarm is added, or the first error otherwise.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_add_alarm_with_localtime alarmmgr_remove_alarms
+ * @remark  No alarm is sent to the server if one of the entries is invalid.
+ *
+ * @par Sample code:
+ * @code
+#include <alarm.h>
+
+ ...
+ {
+	alarm_entry_t *alarms[2];
+	alarm_id_t alarm_ids[2];
+	int ret_val;
+
+	... // create and set alarms[0] and alarms[1]
+
+	ret_val = alarmmgr_add_alarms(alarms, 2, "org.tizen.test", alarm_ids, NULL);
+	if (ret_val != ALARMMGR_RESULT_SUCCESS) {
+		// some of alarms are not added. alarm_ids[i] is -1 for them.
+	}
+ }
+
+ * @endcode
+ * @limo
+ */
+int alarmmgr_add_alarms(alarm_entry_t **alarms, int count,
+			const char *destination, alarm_id_t *alarm_ids,
+			int *results);
+
+/**
+ * This function deletes the alarms associated with the given alarm_ids with one request.
+ *
+ * @param	[in]	alarm_ids	array of the ids of the alarms to be deleted
+ * @param	[in]	count		the number of ids in alarm_ids (1 to 256)
+ * @param	[out]	results		array of count error codes, or NULL
+ *
+ * @return	This function returns ALARMMGR_RESULT_SUCCESS when every alarm is deleted, or the first error otherwise.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_add_alarms alarmmgr_remove_alarm
+ * @remark  None.
+ * @limo
+ */
+int alarmmgr_remove_alarms(const alarm_id_t *alarm_ids, int count,
+			   int *results);
+
 /**
  * This function gives a list of alarm ids that the application adds to the server.
  *
@@ -1172,6 +1344,84 @@ int alarmmgr_remove_alarm(alarm_id_t alarm_id);
  */
 int alarmmgr_enum_alarm_ids(alarm_enum_fn_t fn, void *user_param);
 
+/**
+ * This function starts to enumerate the alarms that the application adds to the server.
+ * The alarms are got from the server page by page, each page with their ids and
+ * information, so that alarmmgr_get_info() does not need to be called for each alarm.
+ * The alarms are enumerated in the order of their ids, and an alarm added or
+ * removed during the enumeration does not make any other alarm skipped.
+ *
+ * @param	[in]	page_size	the number of alarms got at once (1 to 256), or 0 for 256
+ * @param	[out]	iter		the iterator, to be released by alarmmgr_enum_alarms_end()
+ *
+ * @return			This function returns ALARMMGR_RESULT_SUCCESS on success or a negative number on failure.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_enum_alarms_next alarmmgr_enum_alarms_end
+ * @remark  None.
+ *
+ * @par Sample code:
+ * @code
+#include <alarm.h>
+
+ ...
+ {
+	alarm_enum_t *iter;
+	alarm_entry_t *alarm = alarmmgr_create_alarm();
+	alarm_id_t alarm_id;
+
+	if (alarmmgr_enum_alarms_begin(0, &iter) != ALARMMGR_RESULT_SUCCESS)
+		return;
+
+	while (alarmmgr_enum_alarms_next(iter, &alarm_id, alarm) == ALARMMGR_RESULT_SUCCESS
+	       && alarm_id != -1) {
+		// alarm has the information of alarm_id
+	}
+
+	alarmmgr_enum_alarms_end(iter);
+	alarmmgr_free_alarm(alarm);
+ }
+
+ * @endcode
+ * @limo
+ */
+int alarmmgr_enum_alarms_begin(int page_size, alarm_enum_t **iter);
+
+/**
+ * This function gets the next alarm of the enumeration. The next page is got from
+ * the server when all the alarms of the current page have been got.
+ *
+ * @param	[in]	iter		the iterator from alarmmgr_enum_alarms_begin()
+ * @param	[out]	alarm_id	the id of the alarm, -1 when there is no alarm left
+ * @param	[out]	alarm		the buffer the alarm information will be copied to, or NULL
+ *
+ * @return			This function returns ALARMMGR_RESULT_SUCCESS on success or a negative number on failure.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_enum_alarms_begin alarmmgr_enum_alarms_end
+ * @remark  None.
+ * @limo
+ */
+int alarmmgr_enum_alarms_next(alarm_enum_t *iter, alarm_id_t *alarm_id,
+			      alarm_entry_t *alarm);
+
+/**
+ * This function releases the iterator of alarmmgr_enum_alarms_begin().
+ *
+ * @param	[in]	iter		the iterator
+ *
+ * @return			This function returns ALARMMGR_RESULT_SUCCESS on success or a negative number on failure.
+ *
+ * @pre None.
+ * @post None.
+ * @see alarmmgr_enum_alarms_begin
+ * @remark  None.
+ * @limo
+ */
+int alarmmgr_enum_alarms_end(alarm_enum_t *iter);
+
 
 /**
  * This function gets the information of the alarm assosiated with alarm_id to alarm_info. The application